@@ -0,0 +1,112 @@
+/*!
+ * @file ConnectionGraph.cpp
+ * @author tom96da
+ * @brief ConnectionGraph クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "ConnectionGraph.hpp"
+
+#include <algorithm>
+
+/* 接続グラフの CSR スナップショットクラス */
+
+/*!
+ * @brief コンストラクタ (ノードのないグラフ)
+ */
+ConnectionGraph::ConnectionGraph() : offsets_{0} {}
+
+/*!
+ * @return int ノード数
+ */
+int ConnectionGraph::getNumNodes() const { return offsets_.size() - 1; }
+
+/*!
+ * @return int 接続数 (無向辺の数)
+ */
+int ConnectionGraph::getNumEdges() const { return neighbors_.size() / 2; }
+
+/*!
+ * @param id ノードID
+ * @return int 接続中のノード数
+ */
+int ConnectionGraph::getDegree(const int id) const {
+    return offsets_[id + 1] - offsets_[id];
+}
+
+/*!
+ * @param id ノードID
+ * @return span<const int> 接続中のノードのID (昇順)
+ */
+span<const int> ConnectionGraph::getNeighbors(const int id) const {
+    return {neighbors_.data() + offsets_[id],
+            static_cast<size_t>(getDegree(id))};
+}
+
+/*!
+ * @brief ノード同士が接続しているか取得
+ * @param id_1 ノードID1
+ * @param id_2 ノードID2
+ * @retval true 接続している
+ * @retval false 接続していない
+ */
+bool ConnectionGraph::isAdjacent(const int id_1, const int id_2) const {
+    if (id_1 < 0 || id_1 >= getNumNodes()) {
+        return false;
+    }
+
+    const auto neighbors = getNeighbors(id_1);
+    return binary_search(neighbors.begin(), neighbors.end(), id_2);
+}
+
+/*!
+ * @brief すべてのノードを幅優先探索の訪問順に並べる
+ * @details 続けて訪れるノードの隣接リストが重なるので、この順に処理すると
+ *          ID順よりキャッシュに載りやすい
+ * @return vector<int> 訪問順のノードID (連結成分ごとに続けて並べる)
+ */
+vector<int> ConnectionGraph::makeTraversalOrder() const {
+    vector<int> order;
+    order.reserve(getNumNodes());
+    vector<bool> is_visited(getNumNodes(), false);
+
+    for (int id_root = 0; id_root < getNumNodes(); id_root++) {
+        if (is_visited[id_root]) {
+            continue;
+        }
+        /* 未訪問のノードから連結成分を探索する */
+        is_visited[id_root] = true;
+        order.push_back(id_root);
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            for (const auto id_next : getNeighbors(order[head])) {
+                if (!is_visited[id_next]) {
+                    is_visited[id_next] = true;
+                    order.push_back(id_next);
+                }
+            }
+        }
+    }
+
+    return order;
+}
+
+/*!
+ * @brief 各ノードの接続中ノードの集合からスナップショットを構築する
+ * @param num_nodes ノード数 (ノードIDは 0 から連番)
+ * @param connected_of ノードIDから接続中のノードの集合を得る処理
+ */
+void ConnectionGraph::build(
+    const int num_nodes,
+    const function<span<const int>(int)> &connected_of) {
+    offsets_.assign(1, 0);
+    offsets_.reserve(num_nodes + 1);
+    neighbors_.clear();
+
+    for (int id = 0; id < num_nodes; id++) {
+        /* 接続中のノードは昇順なのでそのまま連結する */
+        const auto &connected = connected_of(id);
+        neighbors_.insert(neighbors_.end(), connected.begin(),
+                          connected.end());
+        offsets_.push_back(neighbors_.size());
+    }
+}
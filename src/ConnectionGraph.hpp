@@ -0,0 +1,42 @@
+/*!
+ * @file ConnectionGraph.hpp
+ * @author tom96da
+ * @brief ConnectionGraph クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef CONNECTIONGRAPH_HPP
+#define CONNECTIONGRAPH_HPP
+
+#include <functional>
+#include <span>
+#include <vector>
+
+using namespace std;
+
+/* 接続グラフの CSR (compressed sparse row) スナップショットクラス */
+/* 構築後は変更しないので、複数スレッドから同時に読み出せる */
+class ConnectionGraph {
+   private:
+    /* ノードごとの隣接リストの先頭位置 (ID順, 末尾に総数) */
+    vector<int> offsets_;
+    /* ID順に連結した隣接ノード (各ノード内は昇順) */
+    vector<int> neighbors_;
+
+   public:
+    ConnectionGraph();
+
+    int getNumNodes() const;
+    int getNumEdges() const;
+    int getDegree(const int id) const;
+    span<const int> getNeighbors(const int id) const;
+    bool isAdjacent(const int id_1, const int id_2) const;
+    vector<int> makeTraversalOrder() const;
+
+    void build(const int num_nodes,
+               const function<span<const int>(int)> &connected_of);
+};
+
+#include "ConnectionGraph.cpp"
+
+#endif  // CONNECTIONGRAPH_HPP
@@ -0,0 +1,138 @@
+/*!
+ * @file ConnectionSet.cpp
+ * @author tom96da
+ * @brief ConnectionSet クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "ConnectionSet.hpp"
+
+#include <algorithm>
+
+/* 接続中デバイスの固定長集合クラス */
+
+/*!
+ * @brief コンストラクタ (空の集合)
+ */
+template <int CAPACITY>
+ConnectionSet<CAPACITY>::ConnectionSet() : size_{0} {
+    ids_.fill(INT_MAX);
+}
+
+/*!
+ * @return int 接続中のIDの数
+ */
+template <int CAPACITY>
+int ConnectionSet<CAPACITY>::getSize() const { return size_; }
+
+/*!
+ * @retval true 空きスロットがない
+ * @retval false 空きスロットがある
+ */
+template <int CAPACITY>
+bool ConnectionSet<CAPACITY>::isFull() const { return size_ == CAPACITY; }
+
+/*!
+ * @brief IDが集合に含まれるか取得
+ * @param id デバイスID
+ * @retval true 含まれる
+ * @retval false 含まれない
+ */
+template <int CAPACITY>
+bool ConnectionSet<CAPACITY>::contains(const int id) const {
+    /* 空きスロットも INT_MAX と比べるだけなので、全スロットを分岐なしで見る */
+    bool is_found = false;
+    for (const auto id_slot : ids_) {
+        is_found |= id_slot == id;
+    }
+
+    return is_found;
+}
+
+/*!
+ * @return span<const int> 接続中のID (昇順)
+ */
+template <int CAPACITY>
+span<const int> ConnectionSet<CAPACITY>::getIds() const {
+    return {ids_.data(), size_};
+}
+
+/*!
+ * @return const int* 先頭のID
+ */
+template <int CAPACITY>
+const int *ConnectionSet<CAPACITY>::begin() const { return ids_.data(); }
+
+/*!
+ * @return const int* 末尾のIDの次
+ */
+template <int CAPACITY>
+const int *ConnectionSet<CAPACITY>::end() const { return ids_.data() + size_; }
+
+/*!
+ * @brief IDを昇順の位置に挿入する
+ * @param id デバイスID
+ * @retval true 挿入した
+ * @retval false 含まれているか、空きスロットがない
+ */
+template <int CAPACITY>
+bool ConnectionSet<CAPACITY>::insert(const int id) {
+    if (isFull() || contains(id)) {
+        return false;
+    }
+
+    /* 挿入位置より後ろのIDを1つずつ後ろにずらす */
+    int slot = size_;
+    for (; slot > 0 && ids_[slot - 1] > id; slot--) {
+        ids_[slot] = ids_[slot - 1];
+    }
+    ids_[slot] = id;
+    ++size_;
+
+    return true;
+}
+
+/*!
+ * @brief IDを取り除く
+ * @param id デバイスID
+ * @retval true 取り除いた
+ * @retval false 含まれていない
+ */
+template <int CAPACITY>
+bool ConnectionSet<CAPACITY>::erase(const int id) {
+    const int slot = getSlot(id);
+    if (slot < 0) {
+        return false;
+    }
+
+    /* 後ろのIDを前に詰め、空いた末尾を空きスロットに戻す */
+    copy(ids_.begin() + slot + 1, ids_.begin() + size_, ids_.begin() + slot);
+    ids_[--size_] = INT_MAX;
+
+    return true;
+}
+
+/*!
+ * @brief すべてのIDを取り除く
+ */
+template <int CAPACITY>
+void ConnectionSet<CAPACITY>::clear() {
+    ids_.fill(INT_MAX);
+    size_ = 0;
+}
+
+/*!
+ * @brief IDが入っているスロットの位置を取得
+ * @param id デバイスID
+ * @return int スロットの位置 (含まれなければ -1)
+ */
+template <int CAPACITY>
+int ConnectionSet<CAPACITY>::getSlot(const int id) const {
+    for (int slot = 0; slot < size_; slot++) {
+        if (ids_[slot] == id) {
+            return slot;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,53 @@
+/*!
+ * @file ConnectionSet.hpp
+ * @author tom96da
+ * @brief ConnectionSet クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef CONNECTIONSET_HPP
+#define CONNECTIONSET_HPP
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <span>
+
+using namespace std;
+
+/* 接続中デバイスの固定長集合クラス */
+/* 最大接続数をコンパイル時に決め、IDを昇順の配列でオブジェクト内に持つ。
+   空きスロットは INT_MAX で埋めておくので、所属判定は全スロットとの比較を
+   分岐なしで行える。 */
+template <int CAPACITY>
+class ConnectionSet {
+    static_assert(CAPACITY > 0 && CAPACITY <= UINT8_MAX);
+
+   private:
+    /* 接続中のID (先頭から昇順, 空きスロットは INT_MAX) */
+    array<int, CAPACITY> ids_;
+    /* 接続中のIDの数 */
+    uint8_t size_;
+
+   public:
+    ConnectionSet();
+
+    int getSize() const;
+    bool isFull() const;
+    bool contains(const int id) const;
+    span<const int> getIds() const;
+
+    const int *begin() const;
+    const int *end() const;
+
+    bool insert(const int id);
+    bool erase(const int id);
+    void clear();
+
+   private:
+    int getSlot(const int id) const;
+};
+
+#include "ConnectionSet.cpp"
+
+#endif  // CONNECTIONSET_HPP
@@ -8,8 +8,10 @@
 #include "Device.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <string>
+#include <utility>
 
 /* Bluetooth デバイスクラス */
 
@@ -17,45 +19,24 @@
  * @brief コンストラクタ
  * @param id デバイスID
  * @param willingness willingness デフォルト値: 3
+ * @param context 所属するシミュレーションのコンテキスト
  */
-Device::Device(const int id, const int willingness)
-    : id_(id),
+Device::Device(const int id, const int willingness, SimulationContext &context)
+    : context_{context},
+      id_(id),
       max_connections_(MAX_CONNECTIONS),
       willingness_{willingness},
-      num_packet_made_{0} {}
-
-/* 累計パケット数 */
-int Device::_num_total_packe_ = 0;
-
-/*!
- * @return int 累計パケット数
- */
-int Device::getTotalPacket() { return _num_total_packe_; }
-
-/*!
- * @return int 新規パケットID
- */
-int Device::getNewSequenceNum() { return _num_total_packe_++; }
-
-/*!
- * @brief 累計パケット数をリセットする
- */
-void Device::resetNumPacket() { _num_total_packe_ = 0; }
-
-/*!
- * @brief 累計パケット数の出力
- */
-void Device::showTotalPacket() {
-    std::cout << "total packets: " << getTotalPacket() << std::endl;
-}
-
-/* シミュレーションモード */
-Device::SimulationMode Device::sim_mode_{Device::SimulationMode::NONE};
-
-/*!
- * @brief シミュレーションモードの設定
- */
-void Device::setSimMode(const SimulationMode sim_mode) { sim_mode_ = sim_mode; }
+      num_packet_made_{0},
+      num_data_made_{0},
+      paired_devices_{context.getMemoryResource()},
+      MPR_{context.getMemoryResource()},
+      tow_hop_neighbors_{context.getMemoryResource()},
+      is_neighborhood_changed_{false},
+      generation_sent_{0},
+      tc_seq_num_{0},
+      memory_{make_unique<Memory>(context.getMemoryResource())},
+      topology_db_{
+          make_unique<TopologyDatabase>(context.getMemoryResource())} {}
 
 /*!
  * @return int デバイスID
@@ -83,7 +64,9 @@ int Device::getNumPaired() const { return paired_devices_.size(); }
 /*!
  * @return int 接続中のデバイス数
  */
-int Device::getNumConnected() const { return id_connected_devices_.size(); }
+int Device::getNumConnected() const {
+    return id_connected_devices_.getSize();
+}
 
 /*!
  * @return set<int> ペアリング済みデバイスのIDリスト
@@ -100,14 +83,16 @@ vector<int> Device::getIdPairedDevices() const {
 }
 
 /*!
- * @return set<int> 接続中デバイスのIDリスト
+ * @return span<const int> 接続中デバイスのID (昇順)
  */
-set<int> Device::getIdConnectedDevices() const { return id_connected_devices_; }
+span<const int> Device::getIdConnectedDevices() const {
+    return id_connected_devices_.getIds();
+}
 
 /*!
  * @return RoutingTable ルーティングテーブル
  */
-Table Device::getTable() const { return table_; }
+const Table &Device::getTable() const { return table_; }
 
 /*!
  * @return int 累計パケット生成数
@@ -122,15 +107,15 @@ int Device::getNewPacketId() const { return num_packet_made_++; }
 /*!
  * @return set<int> MPR集合
  */
-set<int> Device::getMPR() const { return MPR_; }
+set<int> Device::getMPR() const { return {MPR_.begin(), MPR_.end()}; }
 
 /*!
  * @brief メモリからデータを取得
  * @param data_id データ識別子
- * @return pair<size_t, variant> 該当データ
+ * @return pair<size_t, Payload> 該当データ
  */
-pair<size_t, Var> Device::readData(const size_t data_id) const {
-    return memory_.at(data_id).getDataWithId();
+const pair<size_t, Payload> &Device::readData(const size_t data_id) const {
+    return memory_->at(data_id).getDataWithId();
 }
 
 /*!
@@ -150,7 +135,16 @@ bool Device::isPaired(const int id_another_device) const {
  * @retval false 未接続
  */
 bool Device::isConnected(const int id_another_device) const {
-    return id_connected_devices_.count(id_another_device);
+    return id_connected_devices_.contains(id_another_device);
+}
+
+/*!
+ * @brief 接続数が接続最大数に達していないか取得
+ * @retval true まだ接続できる
+ * @retval false 接続最大数に達している
+ */
+bool Device::hasFreeConnection() const {
+    return getNumConnected() < max_connections_;
 }
 
 /*!
@@ -160,7 +154,7 @@ bool Device::isConnected(const int id_another_device) const {
  * @retval false 未保持
  */
 bool Device::hasData(const size_t data_id) const {
-    return memory_.count(data_id);
+    return memory_->hasData(data_id);
 }
 
 /*!
@@ -206,7 +200,7 @@ bool Device::connect(const int id_another_device) {
         return false;
     }
 
-    id_connected_devices_.emplace(id_another_device);
+    id_connected_devices_.insert(id_another_device);
     return true;
 }
 
@@ -228,8 +222,8 @@ void Device::disconnect(const int id_another_device) {
  * @param data_attr データ属性
  * @param flood_step フラッディングホップ数
  */
-void Device::saveData(pair<size_t, Var> data_with_id, const DataAttr data_attr,
-                      int flood_step) {
+void Device::saveData(const pair<size_t, Payload> &data_with_id,
+                      const DataAttr data_attr, int flood_step) {
     /* データID */
     auto &[data_id, _] = data_with_id;
     if (hasData(data_id)) {
@@ -237,33 +231,33 @@ void Device::saveData(pair<size_t, Var> data_with_id, const DataAttr data_attr,
         return;
     }
 
-    memory_.emplace(data_id,
-                    Sell(getId(), -1, data_with_id, data_attr, flood_step));
+    memory_->save(Sell(getId(), -1, data_with_id, data_attr, flood_step));
 }
 
 /*!
  * @brief パケットを保存する
  * @param packet パケット
+ * @retval true 保存した
+ * @retval false すでにデータを持っていた
  */
-void Device::saveData(const Packet &packet) {
-    pair<size_t, Var> data_with_id = packet.getDataWithId();
+bool Device::saveData(const Packet &packet) {
+    const auto &data_with_id = packet.getDataWithId();
     /* データID */
     auto &[data_id, _] = data_with_id;
     if (hasData(data_id)) {
         /* すでにデータを持っていれば終了 */
-        return;
+        return false;
     }
 
-    memory_.emplace(
-        data_id,
-        Sell(packet.getIdSender(), packet.getIdDestinaiton(), data_with_id,
-             packet.getDataAttribute(), packet.getFloodStep()));
+    return memory_->save(Sell(packet.getIdSender(), packet.getIdDestinaiton(),
+                              data_with_id, packet.getDataAttribute(),
+                              packet.getFloodStep()));
 }
 
 /*!
  * @brief メモリをクリアする
  */
-void Device::clearMemory() { memory_.clear(); }
+void Device::clearMemory() { memory_->clear(); }
 
 /*!
  * @brief 接続中のデバイスに文字列を送信する
@@ -289,16 +283,6 @@ void Device::receiveMessage(const int id_sender, string message) {
     std::cout << message << " -> ID_" << this->getId() << endl;
 }
 
-/*!
- * @brief データからパケットを生成する
- * @param data 送信するデータ
- * @return Packet 生成したパケット
- */
-Device::Packet Device::makePacket(const int id_dest, Var data) const {
-    return Packet(getId(), id_dest, getNewPacketId(), getNewSequenceNum(),
-                  assignIdToData(data), DataAttr::NONE);
-}
-
 /*!
  * @brief 識別子付きデータパケットを生成する
  * @param data_with_id 送信する識別子付きデータ
@@ -307,11 +291,12 @@ Device::Packet Device::makePacket(const int id_dest, Var data) const {
  * @return Packet 生成したパケット
  */
 Device::Packet Device::makePacket(const int id_dest,
-                                  pair<size_t, Var> data_with_id,
+                                  const pair<size_t, Payload> &data_with_id,
                                   const DataAttr data_attr,
                                   const int flood_step) const {
-    return Packet(getId(), id_dest, getNewPacketId(), getNewSequenceNum(),
-                  data_with_id, data_attr, flood_step);
+    return Packet(getId(), id_dest, getNewPacketId(),
+                  context_.getNewSequenceNum(), data_with_id, data_attr,
+                  flood_step);
 }
 
 /*!
@@ -320,40 +305,102 @@ Device::Packet Device::makePacket(const int id_dest,
  * @param packet 送信するパケット
  */
 void Device::sendPacket(const int id_receiver, const Packet &packet) {
-    if (isConnected(id_receiver)) {
-        /* 接続中であればパケットを送信する */
-        getPairedDevice(id_receiver).receivePacket(packet);
+    if (!isConnected(id_receiver)) {
+        /* 接続中でなければ終了 */
+        return;
+    }
+
+    /* 送信先デバイス */
+    auto &receiver = getPairedDevice(id_receiver);
+    if (auto *scheduler = context_.getScheduler()) {
+        /* 事象駆動ならリンク遅延の後に届ける */
+        scheduler->schedule(scheduler->getLinkLatency(getId(), id_receiver),
+                            [&receiver, packet] {
+                                receiver.receivePacket(packet);
+                            });
+        return;
     }
+
+    receiver.receivePacket(packet);
 }
 
 /*!
  * @brief 接続中のデバイスからパケットを受信する
  * @param packet 受信するパケット
  */
-void Device::receivePacket(const Packet &packet) { saveData(packet); }
+void Device::receivePacket(const Packet &packet) {
+    if (!saveData(packet) && !reopenFlooding(packet)) {
+        /* 受信済みのデータなら終了 */
+        return;
+    }
+
+    if (context_.getScheduler() != nullptr) {
+        /* 事象駆動なら受信したデータの処理を予約する */
+        scheduleProcessing(packet.getDataAttribute());
+    }
+}
 
 /*!
  * @brief 接続中のデバイスにhello!を送信
  */
 void Device::sendHello() {
-    for (auto id_cncts = getIdConnectedDevices(); auto &id_cnct : id_cncts) {
+    /* すべての隣接デバイスで共有するペイロード */
+    const auto willingness = assignIdToData(
+        Message<DataAttr::WILLINGNESS>{getWillingness()});
+    const auto topology = assignIdToData(Message<DataAttr::TOPOLOGY>{
+        {id_connected_devices_.begin(), id_connected_devices_.end()}});
+
+    for (auto id_cnct : id_connected_devices_) {
         /* 接続中のデバイスに順番に送信する */
         sendPacket(id_cnct,
-                   makePacket(id_cnct, assignIdToData(getWillingness()),
-                              DataAttr::WILLINGNESS));
-        sendPacket(id_cnct, makePacket(id_cnct, assignIdToData(id_cncts),
-                                       DataAttr::TOPOLOGY));
+                   makePacket(id_cnct, willingness, DataAttr::WILLINGNESS));
+        sendPacket(id_cnct, makePacket(id_cnct, topology, DataAttr::TOPOLOGY));
     }
 }
 
 /*!
  * @brief 接続中のデバイスにルーティングテーブルを送信
+ * @details TRIGGERED モードでは、前回の送信から変化したエントリだけを送り、
+ *          変化がなければ何も送らない。LINK_STATE 方式ではテーブルの代わりに
+ *          TC を送る。
  */
 void Device::sendTable() {
-    for (auto &id_cnct : getIdConnectedDevices()) {
+    if (context_.getRoutingMode() == RoutingMode::LINK_STATE) {
+        sendTopologyControl();
+        return;
+    }
+
+    /* 前回の送信から変化したエントリだけを送るか */
+    const bool is_triggered =
+        context_.getTableUpdateMode() == TableUpdateMode::TRIGGERED;
+    if (is_triggered && table_.getGeneration() == generation_sent_) {
+        /* 変化がなければ送信しない */
+        return;
+    }
+
+    /* 送信するテーブル */
+    auto table_to_send =
+        is_triggered ? table_.makeDelta(generation_sent_) : table_;
+    generation_sent_ = table_.getGeneration();
+    if (is_triggered && table_to_send.getNumEntry() == 0) {
+        /* 無効化だけで送るエントリがなければ送信しない */
+        return;
+    }
+
+    /* すべての隣接デバイスで共有するテーブルのスナップショット */
+    /* 受信側は無効なエントリを使わないので、有効なエントリだけを送る */
+    Message<DataAttr::TABLE> message;
+    message.routes.reserve(table_to_send.getNumEntry());
+    table_to_send.forEachEntry([&](const int id_dest, const auto &entry) {
+        if (entry.isValid()) {
+            message.routes.push_back({id_dest, entry.getNumHop()});
+        }
+    });
+    const auto table = assignIdToData(move(message));
+
+    for (auto id_cnct : id_connected_devices_) {
         /* 接続中のデバイスに順番に送信する */
-        sendPacket(id_cnct, makePacket(id_cnct, assignIdToData(getTable()),
-                                       DataAttr::TABLE));
+        sendPacket(id_cnct, makePacket(id_cnct, table, DataAttr::TABLE));
     }
 }
 
@@ -362,12 +409,11 @@ void Device::sendTable() {
  * @return size_t 作成したデータの識別子
  */
 size_t Device::makeFloodData() {
-    pair<size_t, Var> data_with_id =
-        assignIdToData(static_cast<string>("hello!"), true);
+    const auto data_with_id =
+        assignIdToData(Message<DataAttr::FLOODING>{}, true);
     saveData(data_with_id, DataAttr::FLOODING, 0);
 
-    auto [data_id, _] = data_with_id;
-    return data_id;
+    return data_with_id.first;
 }
 
 /*!
@@ -376,46 +422,116 @@ size_t Device::makeFloodData() {
  * デフォルト値: 0
  */
 void Device::flooding(const int flag) {
-    /* 現在のホップ数 */
-    static int _step_new = 0;
     if (flag == 1) {
         /* flag = 1 なら次のホップへ */
-        _step_new++;
+        context_.nextFloodStep();
         return;
     }
     if (flag == -1) {
         /* flag = -1 なら初期化 */
-        _step_new = 0;
+        context_.resetFloodStep();
         return;
     }
+    /* 現在のホップ数 */
+    const int step_new = context_.getFloodStep();
 
-    /* メモリ末尾からフラッディングするデータを走査 */
-    auto itr = find_if(memory_.rbegin(), memory_.rend(),
-                       [](pair<size_t, Device::Sell> &&sell) {
-                           auto &[_, data_in_sell] = sell;
-                           return data_in_sell.getDataAttribute() ==
-                                  DataAttr::FLOODING;
-                       });
-    if (itr == memory_.rend()) {
+    /* 最新の未処理フラッディングデータ */
+    auto *sell = memory_->peekLatest(DataAttr::FLOODING);
+    if (sell == nullptr) {
         /* 見つからなければ終了 */
         return;
     }
 
-    auto &[_, data_in_sell] = *itr;
-    if (data_in_sell.getFloodStep() > _step_new) {
+    if (sell->getFloodStep() > step_new) {
         /* データが受信したばかりのものなら終了 */
         return;
     }
 
-    /* 接続中のデバイスに順に送信する */
-    for (auto id_cnct : getIdConnectedDevices()) {
-        if (id_cnct != data_in_sell.getIdSender()) {
-            sendPacket(id_cnct, makePacket(-1, data_in_sell.getDataWithId(),
-                                           DataAttr::FLOODING, _step_new + 1));
+    forwardFlooding(step_new + 1);
+}
+
+/*!
+ * @brief 最新のフラッディングデータを送信元以外の接続中デバイスに転送する
+ * @details 再送しないデータは転送せずに処理済みにする
+ * @param flood_step 転送後のホップ数
+ */
+void Device::forwardFlooding(const int flood_step) {
+    /* 最新の未処理フラッディングデータ */
+    auto *sell = memory_->peekLatest(DataAttr::FLOODING);
+    if (sell == nullptr) {
+        return;
+    }
+
+    if (shouldRelay(*sell)) {
+        /* 接続中のデバイスに順に送信する */
+        for (auto id_cnct : id_connected_devices_) {
+            if (id_cnct != sell->getIdSender()) {
+                sendPacket(id_cnct,
+                           makePacket(-1, sell->getDataWithId(),
+                                      DataAttr::FLOODING, flood_step));
+            }
         }
+        memory_->markRelayed(sell->getDataId());
     }
 
-    data_in_sell.setDaTaAttribute(DataAttr::NONE);
+    memory_->consumeLatest(DataAttr::FLOODING);
+}
+
+/*!
+ * @brief フラッディングデータを再送するか取得
+ * @details MPR モードでは RFC 3626 3.4 の既定の転送規則に従い、
+ *          発信元と、送信元に MPR として選ばれたデバイスだけが再送する
+ * @param sell フラッディングデータのセル
+ * @retval true 再送する
+ * @retval false 再送しない
+ */
+bool Device::shouldRelay(const Sell &sell) const {
+    if (sell.getDataAttribute() != DataAttr::TOPOLOGY_CONTROL &&
+        context_.getFloodingMode() != FloodingMode::MPR) {
+        /* ブラインドフラッディングなら必ず再送する (TC は常に MPR で配る) */
+        return true;
+    }
+
+    return isSelf(sell.getIdSender()) ||
+           isSelectedAsMPR(sell.getIdSender());
+}
+
+/*!
+ * @brief 受信済みのデータを転送待ちに戻す (MPR フラッディングと TC)
+ * @details 初めは MPR に選んでいない送信元から受信して再送しなかったデータも、
+ *          まだ再送していなければ、自身を MPR に選んだ送信元からの重複受信を
+ *          きっかけに再送する (RFC 3626 3.4)
+ * @param packet 重複して受信したパケット
+ * @retval true 新たに転送待ちにした
+ * @retval false 転送待ちにしなかった (転送待ちのセルの送信元の更新を含む)
+ */
+bool Device::reopenFlooding(const Packet &packet) {
+    /* MPR フラッディングで配るデータか */
+    const bool is_MPR_flooding =
+        packet.getDataAttribute() == DataAttr::TOPOLOGY_CONTROL ||
+        (packet.getDataAttribute() == DataAttr::FLOODING &&
+         context_.getFloodingMode() == FloodingMode::MPR);
+    if (!is_MPR_flooding) {
+        return false;
+    }
+
+    /* データ識別子 */
+    const size_t data_id = packet.getDataWithId().first;
+    if (memory_->isRelayed(data_id) ||
+        !isSelectedAsMPR(packet.getIdSender())) {
+        return false;
+    }
+    if (const auto *sell = memory_->find(data_id);
+        sell != nullptr && shouldRelay(*sell)) {
+        /* すでに再送する予定なら、最初に選んだ送信元のままにする */
+        return false;
+    }
+
+    return memory_->reopen(Sell(packet.getIdSender(),
+                                packet.getIdDestinaiton(),
+                                packet.getDataWithId(),
+                                packet.getDataAttribute(),
+                                packet.getFloodStep()));
 }
 
 /*!
@@ -426,8 +542,8 @@ void Device::flooding(const int flag) {
 pair<int, int> Device::startUnicast(const int id_dest) {
     /* ルーティングテーブル */
     auto &&table = getTable();
-    if (!table.hasEntry(id_dest)) {
-        /* 宛先へのエントリーがなければ終了 */
+    if (!table.isEntryValid(id_dest)) {
+        /* 宛先への有効なエントリーがなければ終了 */
         return {-1, 0};
     }
 
@@ -435,7 +551,7 @@ pair<int, int> Device::startUnicast(const int id_dest) {
     int id_nextHop = table.getIdNextHop(id_dest);
     sendPacket(
         id_nextHop,
-        makePacket(id_dest, assignIdToData(static_cast<string>("hello!")),
+        makePacket(id_dest, assignIdToData(Message<DataAttr::HOPPING>{}),
                    DataAttr::HOPPING));
 
     return {id_nextHop, table.getNumHop(id_dest)};
@@ -446,19 +562,14 @@ pair<int, int> Device::startUnicast(const int id_dest) {
  * @return pair<int, int> 次ホップデバイスのID, 継続フラク
  */
 pair<int, int> Device::hopping() {
-    /* メモリ末尾からホップするメッセージを走査する */
-    auto itr =
-        find_if(memory_.rbegin(), memory_.rend(),
-                [](pair<size_t, Device::Sell> &&sell) {
-                    auto &[_, data_in_sell] = sell;
-                    return data_in_sell.getDataAttribute() == DataAttr::HOPPING;
-                });
-    if (itr == memory_.rend()) {
+    /* 最新のホップするメッセージ */
+    auto *sell = memory_->peekLatest(DataAttr::HOPPING);
+    if (sell == nullptr) {
         /* 見つからなければ終了 */
         return {0, -1};
     }
     /* 見つかったメッセージの保存場所 */
-    auto &[_, data_in_sell] = *itr;
+    auto &data_in_sell = *sell;
     /* メッセージの宛先 */
     int id_dest = data_in_sell.getIdDestinaiton();
     if (id_dest == getId()) {
@@ -468,15 +579,15 @@ pair<int, int> Device::hopping() {
 
     /* ルーティングテーブル */
     auto &&table = getTable();
-    if (!table.hasEntry(id_dest)) {
-        /* 宛先へのエントリーなければ終了 */
+    if (!table.isEntryValid(id_dest)) {
+        /* 宛先への有効なエントリーなければ終了 */
         return {0, -1};
     }
 
     /* 次のポップ先のデバイスID */
     int id_nextHop = table.getIdNextHop(id_dest);
     /* ホップするID付きメッセージ */
-    auto data_with_id = data_in_sell.getDataWithId();
+    const auto &data_with_id = data_in_sell.getDataWithId();
     sendPacket(id_nextHop,
                makePacket(id_dest, data_with_id, DataAttr::HOPPING));
 
@@ -488,6 +599,30 @@ pair<int, int> Device::hopping() {
  */
 void Device::makeMPR() {}
 
+/*!
+ * @brief 外部で選んだ MPR 集合に置き換える
+ * @details 2ホップ隣接の記録は hello から作ったものではないので消去する
+ * @param MPRs MPR のID
+ */
+void Device::setMPR(const vector<int> &MPRs) {
+    MPR_.clear();
+    MPR_.insert(MPRs.begin(), MPRs.end());
+    tow_hop_neighbors_.clear();
+    is_neighborhood_changed_ = true;
+}
+
+/*!
+ * @brief 外部で選んだ MPR 集合と、それが覆う2ホップ隣接に置き換える
+ * @param MPRs MPR のID
+ * @param tow_hop_neighbors 2ホップ隣接 <2ホップ隣接のID, 経由する MPR のID>
+ */
+void Device::setMPR(const vector<int> &MPRs,
+                    const map<int, int> &tow_hop_neighbors) {
+    setMPR(MPRs);
+    tow_hop_neighbors_.insert(tow_hop_neighbors.begin(),
+                              tow_hop_neighbors.end());
+}
+
 /*!
  * @brief MPR集合をクリアする
  */
@@ -495,57 +630,153 @@ void Device::clearMPR() { MPR_.clear(); }
 
 /*!
  * @brief ルーティングテーブルを作成する
- * @retval true 更新あり
+ * @details LINK_STATE 方式では受信した TC でトポロジーデータベースを更新し、
+ *          それか隣接・2ホップ隣接が変わっていれば経路を求め直す
+ * @retval true 更新あり (LINK_STATE 方式では再送する TC がある場合を含む)
  * @retval false 更新無し
  */
 bool Device::makeTable() {
+    if (context_.getRoutingMode() == RoutingMode::LINK_STATE) {
+        if (updateTopology()) {
+            makeTableFromTopology();
+            return true;
+        }
+        return hasTopologyControlToRelay();
+    }
+
     /* 更新件数 */
     int result = 0;
 
     while (true) {
-        /* メモリ末尾から受信したルーティングテーブルを走査する */
-        auto itr = find_if(memory_.rbegin(), memory_.rend(),
-                           [](pair<size_t, Device::Sell> &&sell) {
-                               auto &[_, data_in_sell] = sell;
-                               return data_in_sell.getDataAttribute() ==
-                                      DataAttr::TABLE;
-                           });
-        if (itr == memory_.rend()) {
+        /* 最新の未処理ルーティングテーブル */
+        auto *sell = memory_->peekLatest(DataAttr::TABLE);
+        if (sell == nullptr) {
             /* 見つからなければループを離脱 */
             break;
         }
 
         /* 見つかったテーブルの保存場所 */
-        auto &[__, data_in_sell] = *itr;
+        auto &data_in_sell = *sell;
         /* 送信元のデバイスID */
         auto id_sender = data_in_sell.getIdSender();
         /* 見つかったテーブル */
-        auto table_neighbor = get<Table>(data_in_sell.getData()).getTable();
-
-        /* 見つかったテーブルのエントリーを順に取り込む */
-        for (auto &[id_dest, entry] : table_neighbor) {
-            auto id_nexthop = id_sender;
-            auto distance = entry.getNumHop() + 1;
+        const auto &table_neighbor =
+            data_in_sell.getMessage<DataAttr::TABLE>();
 
+        /* 見つかったテーブルの経路を順に取り込む */
+        for (const auto [id_dest, num_hop] : table_neighbor.routes) {
             if (id_dest == getId()) {
                 /* 宛先が自身であればスルー */
                 continue;
-                ;
             }
             result += static_cast<int>(
-                table_.setEntry(id_dest, id_nexthop, distance));
+                table_.setEntry(id_dest, id_sender, num_hop + 1));
         }
 
-        data_in_sell.setDaTaAttribute(DataAttr::NONE);
+        memory_->consumeLatest(DataAttr::TABLE);
     }
 
     return result > 0 ? true : false;
 }
 
+/*!
+ * @brief 外部で計算したルーティングテーブルに置き換える
+ * @param table ルーティングテーブル
+ */
+void Device::setTable(Table table) {
+    table_ = move(table);
+    generation_sent_ = 0;
+}
+
 /*!
  * @brief ルーティングテーブルをクリアする
  */
-void Device::clearTable() { table_.clearEntryAll(); }
+void Device::clearTable() {
+    table_.clearEntryAll();
+    generation_sent_ = 0;
+    is_neighborhood_changed_ = false;
+    topology_db_->clear();
+    advertised_sent_.clear();
+    tc_originated_ = {};
+    id_neighbors_to_sync_.clear();
+    tc_to_relay_.clear();
+}
+
+/*!
+ * @brief 新たに接続した隣接デバイスへの経路を登録する
+ * @details 相手はまだこちらのテーブルを受け取っていないので、次の送信では
+ *          差分ではなく有効なエントリをすべて広告する。LINK_STATE 方式では
+ *          次の送信でトポロジーデータベースを丸ごと送る。
+ * @param id_neighbor 隣接デバイスのID
+ */
+void Device::linkUp(const int id_neighbor) {
+    table_.setEntry(id_neighbor, id_neighbor, 1);
+    generation_sent_ = 0;
+    is_neighborhood_changed_ = true;
+    if (context_.getRoutingMode() == RoutingMode::LINK_STATE) {
+        id_neighbors_to_sync_.insert(id_neighbor);
+    }
+}
+
+/*!
+ * @brief 切断した隣接デバイスを経由する経路を無効にする
+ * @param id_neighbor 隣接デバイスのID
+ * @return vector<int> 無効にした宛先のID
+ */
+vector<int> Device::linkDown(const int id_neighbor) {
+    vector<int> id_dests;
+    table_.forEachEntry([&](const int id_dest, const auto &entry) {
+        if (entry.isValid() && entry.getIdNextHop() == id_neighbor) {
+            id_dests.push_back(id_dest);
+        }
+    });
+    for (const auto id_dest : id_dests) {
+        table_.markEntryInvalid(id_dest);
+    }
+    is_neighborhood_changed_ = true;
+
+    return id_dests;
+}
+
+/*!
+ * @brief 指定した隣接デバイスを経由する宛先への経路を無効にする
+ * @param id_dest 宛先デバイスID
+ * @param id_via 隣接デバイスのID
+ * @retval true 無効にした
+ * @retval false 経路がないか、別の隣接デバイスを経由している
+ */
+bool Device::invalidateRoute(const int id_dest, const int id_via) {
+    if (!table_.isEntryValid(id_dest) ||
+        table_.getIdNextHop(id_dest) != id_via) {
+        return false;
+    }
+
+    table_.markEntryInvalid(id_dest);
+    return true;
+}
+
+/*!
+ * @brief 無効になった経路を別の隣接デバイス経由に付け替える
+ * @param id_dest 宛先デバイスID
+ * @param id_via 隣接デバイスのID
+ * @param distance 付け替え後のホップ数
+ * @retval true 付け替えた
+ * @retval false 経路が有効なまま
+ */
+bool Device::rerouteRoute(const int id_dest, const int id_via,
+                          const int distance) {
+    if (table_.isEntryValid(id_dest)) {
+        return false;
+    }
+
+    return table_.setEntry(id_dest, id_via, distance);
+}
+
+/*!
+ * @brief 有効な経路を次の送信で広告し直す
+ * @param id_dest 宛先デバイスID
+ */
+void Device::refreshRoute(const int id_dest) { table_.refreshEntry(id_dest); }
 
 /*!
  * @brief ルーティングテーブルの度数分布を集計する
@@ -554,17 +785,22 @@ void Device::clearTable() { table_.clearEntryAll(); }
 map<int, int> Device::calculateTableFrequency() const {
     /* 度数分布 */
     map<int, int> tableFrequency;
-    /* ルーティングテーブル */
-    auto &&table = getTable();
 
-    /* ホップ数ごとにカウントする */
-    for (auto id_dest : table.getDestinations()) {
-        tableFrequency[table.getNumHop(id_dest)]++;
-    }
+    /* 有効なエントリをホップ数ごとにカウントする */
+    table_.forEachEntry([&](const int, const auto &entry) {
+        if (entry.isValid()) {
+            tableFrequency[entry.getNumHop()]++;
+        }
+    });
 
     return tableFrequency;
 }
 
+/*!
+ * @return int トポロジーデータベースの (発信元, 広告隣接) の組の数
+ */
+int Device::getNumTopologyTuple() const { return topology_db_->getNumTuple(); }
+
 /*!
  * @brief ペアリング済みのデバイスの参照を取得
  * @param id 対象デバイスのID
@@ -583,28 +819,287 @@ bool Device::isSelf(const int id_another_device) const {
 }
 
 /*!
- * @brief データにデータ識別子を付与する
- * @param data データ
+ * @brief 自身が相手の MPR 集合に含まれるか (相手の MPR セレクタか) 取得
+ * @details OLSR では hello で通知される MPR 選択を、相手の MPR 集合から読む
+ * @param id_selector 相手デバイスのID
+ * @retval true MPR に選ばれている
+ * @retval false 選ばれていない (ペアリングしていない場合を含む)
+ */
+bool Device::isSelectedAsMPR(const int id_selector) const {
+    auto it = paired_devices_.find(id_selector);
+    return it != paired_devices_.end() && it->second.MPR_.count(getId());
+}
+
+/*!
+ * @brief 受信したデータの処理を処理遅延の後に予約する (事象駆動)
+ * @details データ属性ごとの処理をデータ属性の値で引く表から呼ぶ
+ * @param data_attr 受信したデータの属性
+ */
+void Device::scheduleProcessing(const DataAttr data_attr) {
+    /* データ属性ごとの予約処理 (添字はデータ属性の値) */
+    static constexpr auto handlers = []<size_t... i>(index_sequence<i...>) {
+        return array{
+            &Device::scheduleProcessingOf<static_cast<DataAttr>(i)>...};
+    }(make_index_sequence<Memory::NUM_DATA_ATTR>{});
+
+    (this->*handlers[static_cast<int>(data_attr)])();
+}
+
+/*!
+ * @brief 受信したデータ属性の処理を処理遅延の後に予約する (事象駆動)
+ * @tparam data_attr 受信したデータの属性
+ */
+template <Device::DataAttr data_attr>
+void Device::scheduleProcessingOf() {
+    /* スケジューラ */
+    auto *scheduler = context_.getScheduler();
+    /* 処理遅延 */
+    const double delay = scheduler->getProcessingDelay();
+
+    if constexpr (data_attr == DataAttr::WILLINGNESS) {
+        if (memory_->getNumPending(DataAttr::WILLINGNESS) ==
+            getNumConnected()) {
+            /* すべての隣接デバイスの hello が揃えば MPR を選び広告する */
+            scheduler->schedule(delay, [this, scheduler] {
+                makeMPR();
+                scheduler->markProgress();
+                sendTable();
+                notifyMPRSelection();
+            });
+        }
+    } else if constexpr (data_attr == DataAttr::TABLE ||
+                         data_attr == DataAttr::TOPOLOGY_CONTROL) {
+        if (memory_->getNumPending(data_attr) == 1) {
+            /* 未処理のテーブルはまとめて取り込み、更新があれば広告する */
+            scheduler->schedule(delay, [this, scheduler] {
+                if (makeTable()) {
+                    scheduler->markProgress();
+                    sendTable();
+                }
+            });
+        }
+    } else if constexpr (data_attr == DataAttr::FLOODING) {
+        /* 初めて受信したデータを転送する */
+        scheduler->markProgress();
+        scheduler->schedule(delay, [this] {
+            auto *sell = memory_->peekLatest(DataAttr::FLOODING);
+            if (sell != nullptr) {
+                forwardFlooding(sell->getFloodStep() + 1);
+            }
+        });
+    }
+}
+
+/*!
+ * @brief 自身を MPR に選んだ接続中のデバイス (MPR セレクタ) を集める
+ * @return set<int> MPR セレクタのID
+ */
+set<int> Device::makeMPRSelectors() const {
+    set<int> selectors;
+    for (const auto id_cnct : id_connected_devices_) {
+        if (isSelectedAsMPR(id_cnct)) {
+            selectors.emplace(id_cnct);
+        }
+    }
+
+    return selectors;
+}
+
+/*!
+ * @brief TC を発信し、再送が決まった TC を転送する
+ * @details MPR セレクタ集合が前回の発信から変わっていれば、新しいシーケンス
+ *          ナンバーで TC を発信する (RFC 3626 9.3)。最後の MPR セレクタが
+ *          いなくなったときは、前回広告したリンクを取り消すため空の TC を
+ *          発信する。はじめから MPR セレクタがいなければ何も発信しない。
+ *          新たに接続したデバイスには、切り離されていた間に配られた TC を
+ *          補うため、トポロジーデータベースと自身の最新の TC を丸ごと送る
+ *          (OLSR の定期的な TC 発信の代わり)。
+ */
+void Device::sendTopologyControl() {
+    if (auto selectors = makeMPRSelectors(); selectors != advertised_sent_) {
+        advertised_sent_ = selectors;
+        const auto data_with_id =
+            assignIdToData(Message<DataAttr::TOPOLOGY_CONTROL>{
+                getId(), ++tc_seq_num_, {selectors.begin(), selectors.end()}});
+        /* 自身の TC は受信済み・再送済みとして扱う */
+        const auto sell =
+            Sell(getId(), -1, data_with_id, DataAttr::TOPOLOGY_CONTROL, 0);
+        memory_->save(sell);
+        memory_->consumeLatest(DataAttr::TOPOLOGY_CONTROL);
+        memory_->markRelayed(data_with_id.first);
+        tc_to_relay_.push_back(sell);
+        tc_originated_ = data_with_id;
+    }
+
+    for (const auto id_neighbor : id_neighbors_to_sync_) {
+        if (!isConnected(id_neighbor)) {
+            continue;
+        }
+        if (tc_originated_.second != nullptr) {
+            sendPacket(id_neighbor, makePacket(-1, tc_originated_,
+                                               DataAttr::TOPOLOGY_CONTROL));
+        }
+        topology_db_->forEachData([&](const auto &data_with_id) {
+            sendPacket(id_neighbor, makePacket(-1, data_with_id,
+                                               DataAttr::TOPOLOGY_CONTROL));
+        });
+    }
+
+    for (const auto &sell : tc_to_relay_) {
+        /* 受信元以外の接続中のデバイスに送信する */
+        for (auto id_cnct : id_connected_devices_) {
+            if (id_cnct != sell.getIdSender()) {
+                sendPacket(id_cnct,
+                           makePacket(-1, sell.getDataWithId(),
+                                      DataAttr::TOPOLOGY_CONTROL));
+            }
+        }
+    }
+    tc_to_relay_.clear();
+}
+
+/*!
+ * @brief 受信した TC でトポロジーデータベースを更新し、再送する TC を決める
+ * @details 発信元ごとにシーケンスナンバーが新しい TC だけを記録する。
+ *          TC は MPR フラッディングで配る (RFC 3626 3.4)。新たに接続した
+ *          デバイスから受け取って記録した TC は、自身が発信元のように
+ *          接続中のデバイスに配り直す。
+ * @retval true トポロジーデータベースが変化した
+ * @retval false 変化しなかった
+ */
+bool Device::receiveTopologyControl() {
+    bool is_updated = false;
+
+    for (const auto &sell :
+         memory_->takePending(DataAttr::TOPOLOGY_CONTROL)) {
+        const auto &tc = sell.getMessage<DataAttr::TOPOLOGY_CONTROL>();
+        /* トポロジーデータベースを更新したか */
+        const bool is_new =
+            !isSelf(tc.id_originator) && topology_db_->update(sell);
+        is_updated |= is_new;
+
+        /* 新たに接続したデバイスから補った TC か */
+        const bool is_synced =
+            is_new && id_neighbors_to_sync_.contains(sell.getIdSender());
+        if (!memory_->isRelayed(sell.getDataId()) &&
+            (shouldRelay(sell) || is_synced)) {
+            memory_->markRelayed(sell.getDataId());
+            tc_to_relay_.push_back(sell);
+        }
+    }
+    id_neighbors_to_sync_.clear();
+
+    return is_updated;
+}
+
+/*!
+ * @brief 受信した TC を取り込み、経路を求め直すかを判定する
+ * @details TC の取り込みは試行ごとのアリーナを使うので、デバイスごとに順に
+ *          呼ぶ。経路を求め直す makeTableFromTopology は並列に呼べる。
+ * @retval true トポロジーデータベースか隣接・2ホップ隣接が変化した
+ * @retval false 経路を求め直す必要はない
+ */
+bool Device::updateTopology() {
+    return receiveTopologyControl() || is_neighborhood_changed_;
+}
+
+/*!
+ * @brief 再送する TC があるか取得
+ * @retval true 再送する TC がある
+ * @retval false ない
+ */
+bool Device::hasTopologyControlToRelay() const {
+    return !tc_to_relay_.empty();
+}
+
+/*!
+ * @brief 隣接デバイス・2ホップ隣接・トポロジーデータベースから経路を求める
+ * @details 近いデバイスから順に、TC を発信したデバイスまでの経路をその
+ *          広告隣接へ1ホップ延ばす幅優先探索 (RFC 3626 10)
+ */
+void Device::makeTableFromTopology() {
+    Table table;
+    /* 経路が決まった順のデバイス (ホップ数の昇順) */
+    vector<int> queue;
+
+    for (const auto id_cnct : id_connected_devices_) {
+        table.setEntry(id_cnct, id_cnct, 1);
+        queue.push_back(id_cnct);
+    }
+    for (const auto &[id_tow_hop, id_MPR] : tow_hop_neighbors_) {
+        if (!table.hasEntry(id_tow_hop) && table.hasEntry(id_MPR)) {
+            table.setEntry(id_tow_hop, id_MPR, 2);
+            queue.push_back(id_tow_hop);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        const int id_last = queue[head];
+        const auto *tc = topology_db_->find(id_last);
+        if (tc == nullptr) {
+            continue;
+        }
+        for (const auto id_dest : tc->advertised) {
+            if (isSelf(id_dest) || table.hasEntry(id_dest)) {
+                continue;
+            }
+            /* 広告隣接へは、発信元への経路を1ホップ延ばして届く */
+            table.setEntry(id_dest, table.getIdNextHop(id_last),
+                           table.getNumHop(id_last) + 1);
+            queue.push_back(id_dest);
+        }
+    }
+
+    setTable(move(table));
+    is_neighborhood_changed_ = false;
+}
+
+/*!
+ * @brief MPR に選んだ隣接デバイスに、選んだことを伝える (事象駆動)
+ * @details OLSR の hello による MPR 選択の通知にあたる。通知を受けた
+ *          デバイスは MPR セレクタ集合が変わっていれば TC を発信する。
+ */
+void Device::notifyMPRSelection() {
+    /* スケジューラ */
+    auto *scheduler = context_.getScheduler();
+    if (scheduler == nullptr ||
+        context_.getRoutingMode() != RoutingMode::LINK_STATE) {
+        return;
+    }
+
+    for (const auto id_MPR : MPR_) {
+        auto &device_MPR = getPairedDevice(id_MPR);
+        scheduler->schedule(scheduler->getLinkLatency(getId(), id_MPR) +
+                                scheduler->getProcessingDelay(),
+                            [&device_MPR] { device_MPR.sendTable(); });
+    }
+}
+
+/*!
+ * @brief メッセージにデータ識別子を付与し、共有ペイロードにする
+ * @tparam data_attr メッセージのデータ属性
+ * @param message メッセージ
  * @param is_flooding フラッディングするか
  * @param data_id データ識別子
- * @return pair<size_t, variant> 識別子付きデータ
+ * @return pair<size_t, Payload> 識別子付きデータ
  */
-pair<size_t, Var> Device::assignIdToData(const Var data, const bool is_flooding,
-                                         size_t data_id) const {
+template <Device::DataAttr data_attr>
+pair<size_t, Payload> Device::assignIdToData(Message<data_attr> message,
+                                             const bool is_flooding,
+                                             size_t data_id) const {
     if (data_id == 0) {
-        string s_id = to_string(getId()), s_packet = to_string(getNumPacket());
-        if (!is_flooding) {
-            /* 一般データは上1桁が2 */
-            data_id = stoul("2" + string(3 - s_id.length(), '0') + s_id +
-                            string(6 - s_packet.length(), '0') + s_packet);
-        } else {
-            /* フラッディングデータは上1桁が3 */
-            data_id = stoul("3" + string(3 - s_id.length(), '0') + s_id +
-                            string(6 - s_packet.length(), '0') + s_packet);
-        }
+        /* 上位 8 ビットが種別 (一般データは 2, フラッディングデータは 3)、
+         * 続く 24 ビットがデバイス ID、下位 32 ビットが作成数 */
+        data_id = (size_t{is_flooding ? 3u : 2u} << 56) |
+                  (size_t(getId()) << 32) |
+                  size_t(uint32_t(num_data_made_++));
     }
 
-    return {data_id, data};
+    /* ペイロードは試行ごとのアリーナから確保する */
+    return {data_id, allocate_shared<Message<data_attr>>(
+                         pmr::polymorphic_allocator<Message<data_attr>>(
+                             context_.getMemoryResource()),
+                         std::move(message))};
 }
 
 /* メモリセルクラス */
@@ -617,7 +1112,7 @@ pair<size_t, Var> Device::assignIdToData(const Var data, const bool is_flooding,
  * @param flood_step ホップ数 デフォルト値: 0
  */
 Device::Sell::Sell(const int id_sender, const int id_dest,
-                   const pair<size_t, Var> data_with_id,
+                   const pair<size_t, Payload> &data_with_id,
                    const DataAttr data_attr, const int flood_step)
     : id_sender_{id_sender},
       id_dest_{id_dest},
@@ -644,17 +1139,22 @@ size_t Device::Sell::getDataId() const {
 }
 
 /*!
- * @return variant 識別子無しデータ
+ * @tparam data_attr セルのデータ属性
+ * @return Message<data_attr> 識別子無しメッセージの参照
  */
-Var Device::Sell::getData() const {
-    auto &[_, data] = data_with_id_;
-    return data;
+template <Device::DataAttr data_attr>
+const Device::Message<data_attr> &Device::Sell::getMessage() const {
+    /* ペイロードの型はセルのデータ属性で決まる */
+    assert(data_attr_ == data_attr);
+    return *static_cast<const Message<data_attr> *>(data_with_id_.second.get());
 }
 
 /*!
- * @return pair<size_t, variant> 識別子付きデータ
+ * @return pair<size_t, Payload> 識別子付きデータの参照
  */
-pair<size_t, Var> Device::Sell::getDataWithId() const { return data_with_id_; }
+const pair<size_t, Payload> &Device::Sell::getDataWithId() const {
+    return data_with_id_;
+}
 
 /*!
  * @return Device::DataAttr データ属性
@@ -687,7 +1187,7 @@ void Device::Sell::setDaTaAttribute(const DataAttr data_attr) {
  */
 Device::Packet::Packet(const int id_sender, const int id_dest,
                        const int packet_id, const int seq_num,
-                       const pair<size_t, Var> data_with_id,
+                       const pair<size_t, Payload> &data_with_id,
                        const DataAttr data_attr, const int flood_step)
     : id_sender_{id_sender},
       id_dest_{id_dest},
@@ -715,9 +1215,9 @@ int Device::Packet::getPacketId() const { return packet_id_; }
 int Device::Packet::getSeqNum() const { return seq_num_; }
 
 /*!
- * @return pair<size_t, variant> 識別子付き送信データ
+ * @return pair<size_t, Payload> 識別子付き送信データの参照
  */
-pair<size_t, Var> Device::Packet::getDataWithId() const {
+const pair<size_t, Payload> &Device::Packet::getDataWithId() const {
     return data_with_id_;
 }
 
@@ -730,3 +1230,267 @@ Device::DataAttr Device::Packet::getDataAttribute() const { return data_attr_; }
  * @return int フラッディングステップ数
  */
 int Device::Packet::getFloodStep() const { return flood_step_; }
+
+/* メモリクラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param resource コンテナを確保するメモリリソース
+ */
+Device::Memory::Memory(pmr::memory_resource *resource)
+    : sells_{resource},
+      data_ids_{resource},
+      topology_by_sender_{resource},
+      relayed_ids_{resource} {}
+
+/*!
+ * @brief データを受信済みか取得
+ * @param data_id データ識別子
+ * @retval true 受信済み
+ * @retval false 未受信
+ */
+bool Device::Memory::hasData(const size_t data_id) const {
+    return data_ids_.count(data_id);
+}
+
+/*!
+ * @brief 保持中のセルを参照
+ * @param data_id データ識別子
+ * @return Sell セルの参照
+ */
+const Device::Sell &Device::Memory::at(const size_t data_id) const {
+    return sells_.at(data_id);
+}
+
+/*!
+ * @brief 保持中のセルを参照
+ * @param data_id データ識別子
+ * @return const Sell* セルのポインタ (保持していなければ nullptr)
+ */
+const Device::Sell *Device::Memory::find(const size_t data_id) const {
+    auto it = sells_.find(data_id);
+    return it == sells_.end() ? nullptr : &it->second;
+}
+
+/*!
+ * @param data_attr データ属性
+ * @return int 未処理のセル数
+ */
+int Device::Memory::getNumPending(const DataAttr data_attr) const {
+    return pending_[static_cast<int>(data_attr)].size();
+}
+
+/*!
+ * @brief セルを保存する
+ * @param sell 保存するセル
+ * @retval true 保存した
+ * @retval false 受信済みのため保存しなかった
+ */
+bool Device::Memory::save(const Sell &sell) {
+    /* データ識別子 */
+    const size_t data_id = sell.getDataId();
+    if (!data_ids_.emplace(data_id).second) {
+        /* 受信済みなら終了 */
+        return false;
+    }
+
+    const auto data_attr = sell.getDataAttribute();
+    if (data_attr == DataAttr::TOPOLOGY) {
+        /* トポロジー情報は送信元から引けるようにする */
+        auto [it, is_new] =
+            topology_by_sender_.try_emplace(sell.getIdSender(), data_id);
+        if (!is_new) {
+            /* 同じ送信元の古いトポロジー情報は参照されないので破棄する */
+            auto &pending = pending_[static_cast<int>(data_attr)];
+            erase(pending, it->second);
+            sells_.erase(it->second);
+            it->second = data_id;
+        }
+    }
+
+    sells_.emplace(data_id, sell);
+    pending_[static_cast<int>(data_attr)].emplace_back(data_id);
+
+    return true;
+}
+
+/*!
+ * @brief 受信済みのセルを未処理に戻す
+ * @details 未処理のまま保持していれば、渡したセルで置き換える
+ * @param sell 未処理に戻すセル
+ * @retval true 未処理に戻した
+ * @retval false すでに未処理だったため置き換えた
+ */
+bool Device::Memory::reopen(const Sell &sell) {
+    /* データ識別子 */
+    const size_t data_id = sell.getDataId();
+    data_ids_.emplace(data_id);
+
+    if (sells_.erase(data_id)) {
+        sells_.emplace(data_id, sell);
+        return false;
+    }
+
+    sells_.emplace(data_id, sell);
+    pending_[static_cast<int>(sell.getDataAttribute())].emplace_back(data_id);
+
+    return true;
+}
+
+/*!
+ * @brief 未処理のセルを古い順にすべて取り出す
+ * @param data_attr データ属性
+ * @return vector<Sell> 取り出したセル
+ */
+vector<Device::Sell> Device::Memory::takePending(const DataAttr data_attr) {
+    auto &pending = pending_[static_cast<int>(data_attr)];
+    vector<Sell> sells;
+    sells.reserve(pending.size());
+    for (const auto data_id : pending) {
+        sells.push_back(sells_.at(data_id));
+        sells_.erase(data_id);
+    }
+    pending.clear();
+
+    return sells;
+}
+
+/*!
+ * @brief 最新の未処理セルを参照
+ * @param data_attr データ属性
+ * @return Sell* セルのポインタ (無ければ nullptr)
+ */
+Device::Sell *Device::Memory::peekLatest(const DataAttr data_attr) {
+    auto &pending = pending_[static_cast<int>(data_attr)];
+    if (pending.empty()) {
+        return nullptr;
+    }
+
+    return &sells_.at(pending.back());
+}
+
+/*!
+ * @brief 最新の未処理セルを処理済みにして破棄する
+ * @details データ識別子は重複受信の判定のために残す
+ * @param data_attr データ属性
+ */
+void Device::Memory::consumeLatest(const DataAttr data_attr) {
+    auto &pending = pending_[static_cast<int>(data_attr)];
+    if (pending.empty()) {
+        return;
+    }
+
+    sells_.erase(pending.back());
+    pending.pop_back();
+}
+
+/*!
+ * @brief 送信元の最新トポロジー情報を参照
+ * @param id_sender 送信元デバイスのID
+ * @return Sell* セルのポインタ (無ければ nullptr)
+ */
+Device::Sell *Device::Memory::findTopology(const int id_sender) {
+    if (!topology_by_sender_.count(id_sender)) {
+        return nullptr;
+    }
+
+    return &sells_.at(topology_by_sender_.at(id_sender));
+}
+
+/*!
+ * @brief フラッディングデータを再送済みか取得
+ * @param data_id データ識別子
+ * @retval true 再送済み
+ * @retval false 未再送
+ */
+bool Device::Memory::isRelayed(const size_t data_id) const {
+    return relayed_ids_.count(data_id);
+}
+
+/*!
+ * @brief フラッディングデータを再送済みにする
+ * @param data_id データ識別子
+ */
+void Device::Memory::markRelayed(const size_t data_id) {
+    relayed_ids_.emplace(data_id);
+}
+
+/*!
+ * @brief メモリをクリアする
+ */
+void Device::Memory::clear() {
+    sells_.clear();
+    data_ids_.clear();
+    for (auto &pending : pending_) {
+        pending.clear();
+    }
+    topology_by_sender_.clear();
+    relayed_ids_.clear();
+}
+
+/* トポロジーデータベースクラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param resource 記録の確保に使うメモリリソース
+ */
+Device::TopologyDatabase::TopologyDatabase(pmr::memory_resource *resource)
+    : records_{resource} {}
+
+/*!
+ * @brief 発信元の最新の TC を取得
+ * @param id_originator 発信元デバイスのID
+ * @return const Message<DataAttr::TOPOLOGY_CONTROL>* TC (なければ nullptr)
+ */
+const Device::Message<Device::DataAttr::TOPOLOGY_CONTROL> *
+Device::TopologyDatabase::find(const int id_originator) const {
+    auto it = records_.find(id_originator);
+    return it != records_.end() ? it->second.tc : nullptr;
+}
+
+/*!
+ * @return int 記録した TC の広告隣接の総数 (トポロジーの組の数)
+ */
+int Device::TopologyDatabase::getNumTuple() const {
+    int num_tuple = 0;
+    for (const auto &[_, record] : records_) {
+        num_tuple += record.tc->advertised.size();
+    }
+
+    return num_tuple;
+}
+
+/*!
+ * @brief 記録した識別子付き TC を発信元のID順に渡す
+ * @param func 識別子付きデータ (const pair<size_t, Payload> &) を受け取る処理
+ */
+template <class F>
+void Device::TopologyDatabase::forEachData(F &&func) const {
+    for (const auto &[_, record] : records_) {
+        func(record.data_with_id);
+    }
+}
+
+/*!
+ * @brief 受信した TC が発信元の記録より新しければ置き換える
+ * @param sell TC のセル
+ * @retval true 置き換えた (シーケンスナンバーが新しい)
+ * @retval false 記録の方が新しいか同じ
+ */
+bool Device::TopologyDatabase::update(const Sell &sell) {
+    const auto &tc = sell.getMessage<DataAttr::TOPOLOGY_CONTROL>();
+    auto it = records_.find(tc.id_originator);
+    if (it != records_.end() && it->second.tc->seq_num >= tc.seq_num) {
+        return false;
+    }
+
+    /* ペイロードは複製せずに共有する */
+    records_.insert_or_assign(tc.id_originator,
+                              Record{sell.getDataWithId(), &tc});
+    return true;
+}
+
+/*!
+ * @brief すべての記録を消去する
+ */
+void Device::TopologyDatabase::clear() { records_.clear(); }
@@ -8,15 +8,26 @@
 #ifndef DEVICE_HPP
 #define DEVICE_HPP
 
+#include <array>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <set>
 #include <string>
-#include <variant>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include "ConnectionSet.hpp"
+#include "SimulationContext.hpp"
 #include "routingTable.hpp"
 
 using namespace std;
-using Var = variant<int, double, string, set<int>, Table>;
+
+/* 共有される不変ペイロード (受信したすべてのデバイスで同じ実体を参照する) */
+/* 中身はデータ属性ごとのメッセージ型 (Device::Message) で、型はデータ属性から
+   決まるので、メッセージの種類を増やしてもパケットは大きくならない */
+using Payload = shared_ptr<const void>;
 
 /* 最大接続数 */
 const int MAX_CONNECTIONS = 6;
@@ -25,13 +36,17 @@ const int MAX_CONNECTIONS = 6;
 class Device {
    public:
     /* シミュレーションモード列挙型 */
-    enum class SimulationMode;
+    using SimulationMode = SimulationContext::SimulationMode;
+    /* ルーティングテーブル更新モード列挙型 */
+    using TableUpdateMode = SimulationContext::TableUpdateMode;
+    /* フラッディングモード列挙型 */
+    using FloodingMode = SimulationContext::FloodingMode;
+    /* ルーティング方式列挙型 */
+    using RoutingMode = SimulationContext::RoutingMode;
 
    protected:
-    /* 累計パケット数 */
-    static int _num_total_packe_;
-    /* シミュレーションモード */
-    static SimulationMode sim_mode_;
+    /* シミュレーションコンテキスト */
+    SimulationContext &context_;
 
     /* デバイスID */
     const int id_;
@@ -42,36 +57,56 @@ class Device {
 
     /* 累計パケット生成数 */
     mutable int num_packet_made_;
+    /* 累計データ生成数 */
+    mutable int num_data_made_;
+    /* 以下のノードベースのコンテナは試行ごとのアリーナから確保する */
     /* ペアリング登録済みデバイス */
-    map<int, Device &> paired_devices_;
-    /* 接続中デバイス */
-    set<int> id_connected_devices_;
+    pmr::map<int, Device &> paired_devices_;
+    /* 接続中デバイス (最大接続数分のスロットをオブジェクト内に持つ) */
+    ConnectionSet<MAX_CONNECTIONS> id_connected_devices_;
     /* MPR集合 */
-    set<int> MPR_;
+    pmr::set<int> MPR_;
     /* 2ホップ隣接 <tow hop neighbor, MPR> */
-    map<int, int> tow_hop_neighbors_;
+    pmr::map<int, int> tow_hop_neighbors_;
+    /* 隣接・2ホップ隣接が経路を求めた後に変わったか (LINK_STATE 方式) */
+    bool is_neighborhood_changed_;
     /* ルーティングテーブル */
     Table table_;
+    /* 最後に送信したときのルーティングテーブルの世代 */
+    int generation_sent_;
+    /* 最後に発信した TC の広告隣接集合 */
+    set<int> advertised_sent_;
+    /* 最後に発信した識別子付き TC */
+    pair<size_t, Payload> tc_originated_;
+    /* 発信した TC のシーケンスナンバー */
+    int tc_seq_num_;
+    /* トポロジーデータベースを送る、新たに接続したデバイス */
+    set<int> id_neighbors_to_sync_;
 
     /* データ属性列挙型クラス */
     enum class DataAttr;
+    /* データ属性ごとのメッセージ型 (データ属性で特殊化して登録する) */
+    template <DataAttr data_attr>
+    struct Message;
 
     /* メモリセルクラス */
     class Sell;
+    /* メモリクラス */
+    class Memory;
     /* メモリ */
-    map<size_t, Sell> memory_;
+    unique_ptr<Memory> memory_;
+    /* トポロジーデータベースクラス */
+    class TopologyDatabase;
+    /* トポロジーデータベース (発信元ごとの最新の TC) */
+    unique_ptr<TopologyDatabase> topology_db_;
+    /* 次の送信で再送する TC */
+    vector<Sell> tc_to_relay_;
 
     /* パケットクラス */
     class Packet;
 
    public:
-    Device(const int id, const int willingness);
-
-    static int getTotalPacket();
-    static int getNewSequenceNum();
-    static void resetNumPacket();
-    static void showTotalPacket();
-    static void setSimMode(const SimulationMode sim_mode);
+    Device(const int id, const int willingness, SimulationContext &context);
 
     int getId() const;
     virtual string getName();
@@ -80,34 +115,35 @@ class Device {
     int getNumPaired() const;
     int getNumConnected() const;
     vector<int> getIdPairedDevices() const;
-    set<int> getIdConnectedDevices() const;
-    Table getTable() const;
+    span<const int> getIdConnectedDevices() const;
+    const Table &getTable() const;
 
     int getNumPacket() const;
     int getNewPacketId() const;
 
     set<int> getMPR() const;
 
-    pair<size_t, Var> readData(const size_t data_id) const;
+    const pair<size_t, Payload> &readData(const size_t data_id) const;
 
     bool isPaired(const int id_another_device) const;
     bool isConnected(const int id_another_device) const;
+    bool hasFreeConnection() const;
     bool hasData(const size_t data_id) const;
 
     void pairing(Device &another_device);
     void unpairing(const int id_another_device);
     bool connect(const int id_another_device);
     void disconnect(const int id_another_device);
-    void saveData(pair<size_t, Var> data_with_id, const DataAttr data_attr,
-                  int flood_step = 0);
-    void saveData(const Packet &packet);
+    void saveData(const pair<size_t, Payload> &data_with_id,
+                  const DataAttr data_attr, int flood_step = 0);
+    bool saveData(const Packet &packet);
     void clearMemory();
 
     void sendMessage(const int id_receiver, string message);
     void receiveMessage(const int id_sender, string message);
 
-    Packet makePacket(const int id_dest, Var data) const;
-    Packet makePacket(const int id_dest, pair<size_t, Var> data_with_id,
+    Packet makePacket(const int id_dest,
+                      const pair<size_t, Payload> &data_with_id,
                       const DataAttr data_attr, const int flood_step = 0) const;
     void sendPacket(const int id_receiver, const Packet &packet);
     void receivePacket(const Packet &packet);
@@ -121,28 +157,48 @@ class Device {
     pair<int, int> hopping();
 
     virtual void makeMPR();
+    void setMPR(const vector<int> &MPRs);
+    void setMPR(const vector<int> &MPRs,
+                const map<int, int> &tow_hop_neighbors);
     void clearMPR();
 
     bool makeTable();
+    bool updateTopology();
+    bool hasTopologyControlToRelay() const;
+    void makeTableFromTopology();
+    void setTable(Table table);
     void clearTable();
+    void linkUp(const int id_neighbor);
+    vector<int> linkDown(const int id_neighbor);
+    bool invalidateRoute(const int id_dest, const int id_via);
+    bool rerouteRoute(const int id_dest, const int id_via,
+                      const int distance);
+    void refreshRoute(const int id_dest);
     map<int, int> calculateTableFrequency() const;
+    int getNumTopologyTuple() const;
 
    protected:
     Device &getPairedDevice(const int id);
 
     bool isSelf(const int id_another_device) const;
-
-    pair<size_t, Var> assignIdToData(const Var data,
-                                     const bool is_flooding = false,
-                                     size_t data_id = 0) const;
-};
-
-/* シミュレーションモード */
-enum class Device::SimulationMode {
-    NONE,
-    CONVENTIONAL,             /* 既存手法 */
-    PROPOSAL_LONG_CONNECTION, /* 提案手法 遠距離接続 */
-    PROPOSAL_LONG_MPR         /* 提案手法 遠距離MPR 没案 */
+    bool isSelectedAsMPR(const int id_selector) const;
+
+    bool shouldRelay(const Sell &sell) const;
+    bool reopenFlooding(const Packet &packet);
+    void forwardFlooding(const int flood_step);
+    void scheduleProcessing(const DataAttr data_attr);
+    template <DataAttr data_attr>
+    void scheduleProcessingOf();
+
+    set<int> makeMPRSelectors() const;
+    void sendTopologyControl();
+    bool receiveTopologyControl();
+    void notifyMPRSelection();
+
+    template <DataAttr data_attr>
+    pair<size_t, Payload> assignIdToData(Message<data_attr> message,
+                                         const bool is_flooding = false,
+                                         size_t data_id = 0) const;
 };
 
 /* データ属性 */
@@ -153,9 +209,52 @@ enum class Device::DataAttr {
     TABLE,
     FLOODING,
     NEXT_FLOOD,
+    TOPOLOGY_CONTROL,
     HOPPING
 };
 
+/* hello で送る willingness */
+template <>
+struct Device::Message<Device::DataAttr::WILLINGNESS> {
+    int willingness;
+};
+
+/* hello で送る接続中デバイス */
+template <>
+struct Device::Message<Device::DataAttr::TOPOLOGY> {
+    /* 接続中デバイスのID (昇順) */
+    vector<int> id_connected;
+};
+
+/* ルーティングテーブル (有効なエントリだけ) */
+template <>
+struct Device::Message<Device::DataAttr::TABLE> {
+    /* 経路 */
+    struct Route {
+        int id_dest; /* 宛先デバイスのID */
+        int num_hop; /* 宛先までのホップ数 */
+    };
+    /* 宛先IDの昇順の経路 */
+    vector<Route> routes;
+};
+
+/* フラッディングデータ (本文を持たない) */
+template <>
+struct Device::Message<Device::DataAttr::FLOODING> {};
+
+/* TC (topology control) */
+template <>
+struct Device::Message<Device::DataAttr::TOPOLOGY_CONTROL> {
+    int id_originator; /* 発信元デバイスのID */
+    int seq_num;       /* 発信元ごとのシーケンスナンバー */
+    /* 広告する隣接デバイス (発信元の MPR セレクタ, 昇順) */
+    vector<int> advertised;
+};
+
+/* ルーティングテーブルに従ってホップするメッセージ (本文を持たない) */
+template <>
+struct Device::Message<Device::DataAttr::HOPPING> {};
+
 /* メモリセルクラス */
 class Device::Sell {
    private:
@@ -165,7 +264,7 @@ class Device::Sell {
     const int id_dest_;
 
     /* 識別子付きデータ */
-    const pair<size_t, Var> data_with_id_;
+    const pair<size_t, Payload> data_with_id_;
     /* データ属性 */
     DataAttr data_attr_;
 
@@ -174,21 +273,90 @@ class Device::Sell {
 
    public:
     Sell(const int id_sender, const int id_dest,
-         const pair<size_t, Var> data_with_id, const DataAttr data_attr,
+         const pair<size_t, Payload> &data_with_id, const DataAttr data_attr,
          const int flood_step);
 
     int getIdSender() const;
     int getIdDestinaiton() const;
     size_t getDataId() const;
 
-    Var getData() const;
-    pair<size_t, Var> getDataWithId() const;
+    template <DataAttr data_attr>
+    const Message<data_attr> &getMessage() const;
+    const pair<size_t, Payload> &getDataWithId() const;
     DataAttr getDataAttribute() const;
     int getFloodStep() const;
 
     void setDaTaAttribute(const DataAttr data_attr);
 };
 
+/* メモリクラス */
+/* データ属性ごとの未処理キューで「最新の未処理データ」を O(1) で取り出す */
+class Device::Memory {
+   public:
+    /* データ属性の種類数 */
+    static constexpr int NUM_DATA_ATTR =
+        static_cast<int>(DataAttr::HOPPING) + 1;
+
+   private:
+    /* 保持中のセル <データ識別子, セル> */
+    pmr::unordered_map<size_t, Sell> sells_;
+    /* 受信済みのデータ識別子 (処理済みで破棄したものも含む) */
+    pmr::unordered_set<size_t> data_ids_;
+    /* データ属性ごとの未処理キュー (末尾が最新) */
+    array<vector<size_t>, NUM_DATA_ATTR> pending_;
+    /* 送信元ごとの最新トポロジー情報 <送信元ID, データ識別子> */
+    pmr::unordered_map<int, size_t> topology_by_sender_;
+    /* 再送済みのフラッディングデータ識別子 */
+    pmr::unordered_set<size_t> relayed_ids_;
+
+   public:
+    Memory(pmr::memory_resource *resource);
+
+    bool hasData(const size_t data_id) const;
+    const Sell &at(const size_t data_id) const;
+    const Sell *find(const size_t data_id) const;
+
+    int getNumPending(const DataAttr data_attr) const;
+
+    bool save(const Sell &sell);
+    bool reopen(const Sell &sell);
+    vector<Sell> takePending(const DataAttr data_attr);
+    Sell *peekLatest(const DataAttr data_attr);
+    void consumeLatest(const DataAttr data_attr);
+    Sell *findTopology(const int id_sender);
+    bool isRelayed(const size_t data_id) const;
+    void markRelayed(const size_t data_id);
+    void clear();
+};
+
+/* トポロジーデータベースクラス */
+/* 受信した TC のペイロードを複製せずに共有し、型付きで引けるようにしておく */
+class Device::TopologyDatabase {
+   private:
+    /* 記録した TC */
+    struct Record {
+        /* 識別子付きデータ (受信したペイロードを共有する) */
+        pair<size_t, Payload> data_with_id;
+        /* ペイロードの TC */
+        const Message<DataAttr::TOPOLOGY_CONTROL> *tc;
+    };
+
+    /* 発信元ごとの最新の TC <発信元ID, 記録> */
+    pmr::map<int, Record> records_;
+
+   public:
+    TopologyDatabase(pmr::memory_resource *resource);
+
+    const Message<DataAttr::TOPOLOGY_CONTROL> *find(
+        const int id_originator) const;
+    int getNumTuple() const;
+    template <class F>
+    void forEachData(F &&func) const;
+
+    bool update(const Sell &sell);
+    void clear();
+};
+
 /* パケットクラス */
 class Device::Packet {
    private:
@@ -202,7 +370,7 @@ class Device::Packet {
     const int seq_num_;
 
     /* 識別子付きデータ */
-    const pair<size_t, Var> data_with_id_;
+    const pair<size_t, Payload> data_with_id_;
     /* データ属性 */
     DataAttr data_attr_;
 
@@ -211,7 +379,7 @@ class Device::Packet {
 
    public:
     Packet(const int id_sender, const int id_dest, const int packet_id,
-           const int seq_num, const pair<size_t, Var> data_with_id,
+           const int seq_num, const pair<size_t, Payload> &data_with_id,
            const DataAttr data_attr, const int flood_step = 0);
 
     int getIdSender() const;
@@ -219,7 +387,7 @@ class Device::Packet {
     int getPacketId() const;
     int getSeqNum() const;
 
-    pair<size_t, Var> getDataWithId() const;
+    const pair<size_t, Payload> &getDataWithId() const;
     DataAttr getDataAttribute() const;
     int getFloodStep() const;
 };
@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <iostream>
 #include <numbers>
+#include <numeric>
 #include <utility>
 
 /* デバイスマネージャー クラス */
@@ -24,52 +25,74 @@
  * @param sim_mode シミュレーションモード
  */
 DeviceManager::DeviceManager(const double field_size)
-    : field_size_{field_size},
-      mt_{random_device{}()},
+    : DeviceManager(field_size, random_device{}()) {}
+
+/*!
+ * @brief コンストラクタ (シード指定)
+ * @param field_size フィールドサイズ
+ * @param seed 乱数シード
+ */
+DeviceManager::DeviceManager(const double field_size, const unsigned int seed)
+    : context_{},
+      field_size_{field_size},
+      is_graph_stale_{true},
+      near_pairs_{field_size_, context_.getMaxComDistance(),
+                  context_.getMaxComDistance() * NEAR_PAIR_MARGIN_RATIO},
+      is_near_pairs_stale_{true},
+      mt_{seed},
       position_random_{0.0, field_size_},
       move_randn_{0, 0.3},
       bias_random_{-0.4, 0.4},
-      willingness_random_{1, 5} {}
+      willingness_random_{1, 5} {
+    bindPolicy<UnspecifiedPolicy>();
+}
 
-/* 最大接続距離 */
-double DeviceManager::_max_com_distance_ = MAX_COM_DISTANCE;
+/*!
+ * @return SimulationContext シミュレーションコンテキストの参照
+ */
+SimulationContext &DeviceManager::getContext() { return context_; }
 
 /*!
  * @return double 接続可能距離
  */
-double DeviceManager::getMaxComDistance() { return _max_com_distance_; }
+double DeviceManager::getMaxComDistance() const {
+    return context_.getMaxComDistance();
+}
 
 /*!
  * @brief シミュレーションモードを設定する
+ * @details モードの方針で特殊化した処理をここで1度だけ選び、以降の
+ *          ネットワーク構築や MPR 選択では分岐しない
  * @param sim_mode
  */
 void DeviceManager::setSimMode(const SimulationMode sim_mode) {
-    /* シミュレーションモード */
-    sim_mode_ = sim_mode;
-
-    switch (sim_mode_) {
-        case SIMMODE::CONVENTIONAL:
-            /* 従来手法 */
-            Device::setSimMode(Device::SimulationMode::CONVENTIONAL);
-            break;
-        case SIMMODE::PROPOSAL_LONG_CONNECTION:
-            /* 提案手法 遠距離接続 */
-            Device::setSimMode(
-                Device::SimulationMode::PROPOSAL_LONG_CONNECTION);
-            break;
-        case SIMMODE::PROPOSAL_LONG_MPR:
-            /* 提案手法 遠距離MPR */
-            Device::setSimMode(Device::SimulationMode::PROPOSAL_LONG_MPR);
-            break;
-        default:
+    dispatchSimMode(sim_mode, [&](const auto policy) {
+        using Policy = decltype(policy);
+        if constexpr (Policy::MODE == SimulationMode::NONE) {
             std::cout
                 << "Please execute after specifying "
                 << "either CONVENTIONAL or PROPOSAL_LONG_CONNECTION for the "
                    "simulation mode."
                 << std::endl;
             std::exit(EXIT_SUCCESS);
-            break;
-    }
+        }
+        bindPolicy<Policy>();
+    });
+}
+
+/*!
+ * @brief シミュレーションモードの方針で特殊化した処理を選ぶ
+ * @tparam Policy シミュレーションモードの方針
+ */
+template <class Policy>
+void DeviceManager::bindPolicy() {
+    context_.setSimMode(Policy::MODE);
+
+    build_network_ = &DeviceManager::buildNetworkWith<Policy>;
+    repair_connections_ = &DeviceManager::repairConnectionsWith<Policy>;
+    select_MPR_ = &DeviceManager::selectMPRWith<Policy>;
+    reselect_MPR_ = &DeviceManager::reselectMPRWith<Policy>;
+    make_MPR_ = &Node::makeMPRWith<Policy>;
 }
 
 /*!
@@ -92,22 +115,20 @@ DeviceManager::Node &DeviceManager::getDeviceById(const int id) {
  */
 vector<int> DeviceManager::getDevicesList() const {
     /* リスト */
-    vector<int> list;
-    for (auto &[id, _] : nodes_) {
-        /* 順にリストに挿入する */
-        list.emplace_back(id);
-    }
+    vector<int> list(getNumDevices());
+    /* IDは 0 から連番 */
+    iota(list.begin(), list.end(), 0);
 
     return list;
 }
 
 /*!
- * @brief IDに合致する座標を参照 (不正なIDではないか事前確認)
+ * @brief IDに合致する座標を取得 (不正なIDではないか事前確認)
  * @param id デバイスID
- * @return pair<double, double> デバイスの座標の参照
+ * @return pair<double, double> デバイスの座標
  */
-pair<double, double> &DeviceManager::getPosition(const int id) {
-    return nodes_.at(id).getPosition();
+pair<double, double> DeviceManager::getPosition(const int id) const {
+    return {pos_x_[id], pos_y_[id]};
 }
 
 /*!
@@ -117,20 +138,51 @@ pair<double, double> &DeviceManager::getPosition(const int id) {
  * @retval 0< デバイス間距離
  * @retval <0 デバイスIDが不正
  */
-double DeviceManager::getDistance(const int id_1, const int id_2) {
-    if (!nodes_.count(id_1)) {
+double DeviceManager::getDistance(const int id_1, const int id_2) const {
+    if (!hasDevice(id_1)) {
         /* デバイスが存在しなければ終了 */
         return -1.0;
     }
-    if (!nodes_.count(id_2)) {
+    if (!hasDevice(id_2)) {
         /* デバイスが存在しなければ終了 */
         return -1.0;
     }
 
-    auto &&[pos_1_x, pos_1_y] = getPosition(id_1);
-    auto &&[pos_2_x, pos_2_y] = getPosition(id_2);
+    return hypot(pos_x_[id_1] - pos_x_[id_2], pos_y_[id_1] - pos_y_[id_2]);
+}
 
-    return hypot(pos_1_x - pos_2_x, pos_1_y - pos_2_y);
+/*!
+ * @brief デバイス間距離の2乗の取得
+ * @details 平方根を取らないので、接続可能距離の2乗と比べる判定に使う
+ * @param id_1 デバイスID1
+ * @param id_2 デバイスID2
+ * @retval 0< デバイス間距離の2乗
+ * @retval <0 デバイスIDが不正
+ */
+double DeviceManager::getSquaredDistance(const int id_1,
+                                         const int id_2) const {
+    if (!hasDevice(id_1) || !hasDevice(id_2)) {
+        /* デバイスが存在しなければ終了 */
+        return -1.0;
+    }
+
+    const double dx = pos_x_[id_1] - pos_x_[id_2];
+    const double dy = pos_y_[id_1] - pos_y_[id_2];
+    return dx * dx + dy * dy;
+}
+
+/*!
+ * @brief 接続グラフのスナップショットを取得する
+ * @details 接続が変わっていれば作り直す。複数スレッドで共有するときは、
+ *          先にこの関数で取得した参照を渡す。
+ * @return const ConnectionGraph& 接続グラフ
+ */
+const ConnectionGraph &DeviceManager::getGraph() {
+    if (is_graph_stale_) {
+        buildGraph();
+    }
+
+    return graph_;
 }
 
 /*!
@@ -139,26 +191,36 @@ double DeviceManager::getDistance(const int id_1, const int id_2) {
  */
 void DeviceManager::addDevices(const int num_devices) {
     /* 追加する先頭のデバイスID */
-    int id_next = 0;
-    if (getNumDevices() > 0) {
-        auto &[id_last, _] = *nodes_.rend();
-        id_next = id_last + 1;
-    }
+    const int id_next = getNumDevices();
 
     for (int id = id_next; id < id_next + num_devices; id++) {
         /* 順にデバイスを生成する */
-        nodes_.emplace(id, Node(id, willingness_random_(mt_), this));
-        nodes_.at(id).setBias(bias_random_(mt_), bias_random_(mt_));
-        nodes_.at(id).setPositon(position_random_(mt_), position_random_(mt_));
+        willingness_.emplace_back(willingness_random_(mt_));
+        bias_x_.emplace_back(bias_random_(mt_));
+        bias_y_.emplace_back(bias_random_(mt_));
+        pos_x_.emplace_back(position_random_(mt_));
+        pos_y_.emplace_back(position_random_(mt_));
+        nodes_.emplace_back(id, willingness_[id], this);
     }
+    is_graph_stale_ = true;
+    is_near_pairs_stale_ = true;
 }
 
 /*!
  * @brief すべてのデバイスを削除する
  */
 void DeviceManager::deleteDeviceAll() {
-    Device::resetNumPacket();
+    context_.resetNumPacket();
     nodes_.clear();
+    /* デバイスのコンテナとペイロードをまとめて解放する */
+    context_.releaseMemory();
+    pos_x_.clear();
+    pos_y_.clear();
+    bias_x_.clear();
+    bias_y_.clear();
+    willingness_.clear();
+    is_graph_stale_ = true;
+    is_near_pairs_stale_ = true;
 }
 
 /*!
@@ -167,11 +229,13 @@ void DeviceManager::deleteDeviceAll() {
  * @param id_2 デバイスID2
  */
 void DeviceManager::pairDevices(const int id_1, const int id_2) {
-    if (getDistance(id_1, id_2) > _max_com_distance_) {
+    /* デバイス間距離の2乗 */
+    const double squared_distance = getSquaredDistance(id_1, id_2);
+    if (squared_distance > getMaxComDistance() * getMaxComDistance()) {
         /* 距離が最大接続距離より離れていたら終了 */
         return;
     }
-    if (getDistance(id_1, id_2) < 0) {
+    if (squared_distance < 0) {
         /* デバイスが存在しなければ終了 */
         return;
     }
@@ -205,6 +269,8 @@ void DeviceManager::unpairDevices(const int id_1, const int id_2) {
 
     getDeviceById(id_1).unpairing(id_2);
     getDeviceById(id_2).unpairing(id_1);
+    /* ペアリング解除で接続も切れる */
+    is_graph_stale_ = true;
 }
 
 /*!
@@ -213,11 +279,13 @@ void DeviceManager::unpairDevices(const int id_1, const int id_2) {
  * @param d2_id デバイスID2
  */
 void DeviceManager::connectDevices(const int id_1, const int id_2) {
-    if (getDistance(id_1, id_2) > _max_com_distance_) {
+    /* デバイス間距離の2乗 */
+    const double squared_distance = getSquaredDistance(id_1, id_2);
+    if (squared_distance > getMaxComDistance() * getMaxComDistance()) {
         /* 距離が最大接続距離より離れていたら終了 */
         return;
     }
-    if (getDistance(id_1, id_2) < 0) {
+    if (squared_distance < 0) {
         /* デバイスが存在しなければ終了 */
         return;
     }
@@ -232,7 +300,9 @@ void DeviceManager::connectDevices(const int id_1, const int id_2) {
 
     if (getDeviceById(id_1).connect(id_2)) {
         /* デバイス1にデバイス2を接続出来たら */
-        if (!getDeviceById(id_2).connect(id_1)) {
+        if (getDeviceById(id_2).connect(id_1)) {
+            is_graph_stale_ = true;
+        } else {
             /* デバイス2にデバイス1を接続できなかったら */
             getDeviceById(id_1).disconnect(id_2);
         }
@@ -245,17 +315,20 @@ void DeviceManager::connectDevices(const int id_1, const int id_2) {
  * @param d2_id デバイスID2
  */
 void DeviceManager::disconnectDevices(const int id_1, const int id_2) {
-    if (getDistance(id_1, id_2) <= _max_com_distance_) {
+    /* デバイス間距離の2乗 */
+    const double squared_distance = getSquaredDistance(id_1, id_2);
+    if (squared_distance <= getMaxComDistance() * getMaxComDistance()) {
         /* 距離が最大接続距離より小さければ終了 */
         return;
     }
-    if (getDistance(id_1, id_2) < 0) {
+    if (squared_distance < 0) {
         /* デバイスが存在しなければ終了 */
         return;
     }
 
     getDeviceById(id_1).disconnect(id_2);
     getDeviceById(id_2).disconnect(id_1);
+    is_graph_stale_ = true;
 }
 
 /*!
@@ -263,7 +336,10 @@ void DeviceManager::disconnectDevices(const int id_1, const int id_2) {
  * @param id デバイスID
  */
 void DeviceManager::disconnectDevices(const int id) {
-    for (auto id_cntd : getDeviceById(id).getIdConnectedDevices()) {
+    /* 切断しながら走査するので、接続中のデバイスを写しておく */
+    const auto id_cncts = getDeviceById(id).getIdConnectedDevices();
+    const vector<int> id_cntds(id_cncts.begin(), id_cncts.end());
+    for (auto id_cntd : id_cntds) {
         /* 順に接続を切る */
         disconnectDevices(id, id_cntd);
     }
@@ -274,7 +350,7 @@ void DeviceManager::disconnectDevices(const int id) {
  * @param id デバイスID
  */
 void DeviceManager::updatePosition(const int id) {
-    if (!nodes_.count(id)) {
+    if (!hasDevice(id)) {
         return;
     }
 
@@ -284,9 +360,9 @@ void DeviceManager::updatePosition(const int id) {
     /* y軸方向変位 */
     double dy = move_randn_(mt_);
     /* 座標 */
-    auto &[pos_x, pos_y] = getPosition(id);
+    auto &pos_x = pos_x_[id], &pos_y = pos_y_[id];
     /* 移動バイアス */
-    auto &[bias_x, bias_y] = getBias(id);
+    auto &bias_x = bias_x_[id], &bias_y = bias_y_[id];
 
     tmp = pos_x + dx + bias_x;
     if ((tmp > 0) & (tmp < field_size_)) {
@@ -310,14 +386,73 @@ void DeviceManager::updatePosition(const int id) {
 }
 
 /*!
- * @brief すべてのデバイスの座標の更新
+ * @brief すべてのデバイスの座標を更新し、変化した接続だけを繋ぎ直す
+ * @details 接続可能距離の境界をまたいだデバイス対を近傍ペアリストで求め、
+ *          距離外に出た接続を切る。その後、新たに距離内に入った対と、
+ *          接続を失ったデバイスの距離内の対だけを接続し直す。
+ *          buildNetwork() と同様、距離内の未接続の対は一方が接続最大数に
+ *          達した状態が保たれる。
+ * @return vector<LinkChange> 変化した接続 (切断, 接続の順)
  */
-void DeviceManager::updatePositionAll() {
-    for (auto id : getDevicesList()) {
-        /* 順に差票を更新する */
+vector<DeviceManager::LinkChange> DeviceManager::updatePositionAll() {
+    if (is_near_pairs_stale_) {
+        /* 移動前の座標で近傍ペアリストを作る */
+        near_pairs_.build(pos_x_, pos_y_);
+        is_near_pairs_stale_ = false;
+    }
+
+    for (int id = 0; id < getNumDevices(); id++) {
+        /* ID順に座標を更新する */
         updatePosition(id);
     }
-    buildNetwork();
+
+    /* 距離内に入った対, 距離外に出た対 */
+    vector<pair<int, int>> entered, left;
+    near_pairs_.update(pos_x_, pos_y_, entered, left);
+
+    vector<LinkChange> changes;
+    /* 接続を失ったデバイス */
+    vector<int> ids_lost;
+    for (const auto &[id_1, id_2] : left) {
+        if (!isConnected(id_1, id_2)) {
+            continue;
+        }
+        /* 距離外に出た接続を切る */
+        disconnectDevices(id_1, id_2);
+        if (isConnected(id_1, id_2)) {
+            /* 境界上で距離の丸め誤差により切れなければ次へ */
+            continue;
+        }
+        changes.push_back({id_1, id_2, false});
+        ids_lost.push_back(id_1);
+        ids_lost.push_back(id_2);
+    }
+
+    /* 接続枠が空いているデバイス同士の距離内の対だけを候補にする */
+    auto hasFreeConnection = [&](const int id) {
+        return getDeviceById(id).hasFreeConnection();
+    };
+    vector<pair<int, int>> candidates;
+    for (const auto &[id_1, id_2] : entered) {
+        /* 新たに距離内に入った対 */
+        if (hasFreeConnection(id_1) && hasFreeConnection(id_2)) {
+            candidates.emplace_back(id_1, id_2);
+        }
+    }
+    for (const auto id_lost : ids_lost) {
+        /* 接続を失ったデバイスの距離内の対 */
+        for (const auto id_near : near_pairs_.getPartners(id_lost)) {
+            if (hasFreeConnection(id_near) &&
+                getDistance(id_lost, id_near) <= getMaxComDistance()) {
+                candidates.emplace_back(min(id_lost, id_near),
+                                        max(id_lost, id_near));
+            }
+        }
+    }
+
+    repairConnections(candidates, changes);
+
+    return changes;
 }
 
 /*!
@@ -337,24 +472,30 @@ void DeviceManager::clearDevice() {
  * @brief ネットワークを構築する
  */
 void DeviceManager::buildNetwork() {
-    switch (sim_mode_) {
-        case SIMMODE::CONVENTIONAL:
-        case SIMMODE::PROPOSAL_LONG_MPR:
-            /* 従来手法 */
-            buildNetworkRandom();
-            break;
-        case SIMMODE::PROPOSAL_LONG_CONNECTION:
-            /* 提案手法 遠距離接続 */
-            buildNetworkByDistance();
-            break;
-        default:
-            std::cout
-                << "Please execute after specifying "
-                << "either CONVENTIONAL or PROPOSAL_LONG_CONNECTION for the "
-                   "simulation mode."
-                << std::endl;
-            std::exit(EXIT_SUCCESS);
-            break;
+    (this->*build_network_)();
+
+    /* 構築した接続グラフのスナップショットを作る */
+    buildGraph();
+}
+
+/*!
+ * @brief シミュレーションモードの方針に従ってネットワークを構築する
+ * @tparam Policy シミュレーションモードの方針
+ */
+template <class Policy>
+void DeviceManager::buildNetworkWith() {
+    if constexpr (Policy::MODE == SimulationMode::NONE) {
+        std::cout << "Please execute after specifying "
+                  << "either CONVENTIONAL or PROPOSAL_LONG_CONNECTION for the "
+                     "simulation mode."
+                  << std::endl;
+        std::exit(EXIT_SUCCESS);
+    } else if constexpr (Policy::IS_FAR_FIRST) {
+        /* 提案手法 遠距離接続 */
+        buildNetworkByDistance();
+    } else {
+        /* 従来手法 */
+        buildNetworkRandom();
     }
 }
 
@@ -363,28 +504,36 @@ void DeviceManager::buildNetwork() {
  */
 void DeviceManager::buildNetworkRandom() {
     /* デバイスIDリスト */
-    auto &&list_1 = getDevicesList();
+    auto &&list = getDevicesList();
 
-    for (auto const id : list_1) {
+    for (auto const id : list) {
         /* 順に距離の離れた接続を切る */
         disconnectDevices(id);
     }
 
-    shuffle(list_1.begin(), list_1.end(), mt_);
+    buildGrid();
+    shuffle(list.begin(), list.end(), mt_);
+
+    /* 接続処理が完了したデバイス */
+    vector<bool> is_done(getNumDevices(), false);
+    /* 近傍候補 */
+    vector<int> candidates;
 
-    auto list_2 = list_1;
+    for (const auto id_1 : list) {
+        /* 接続可能距離内の未処理のデバイスをランダムな順に接続する */
+        auto [pos_x, pos_y] = getPosition(id_1);
+        grid_.getNeighbors(pos_x, pos_y, getMaxComDistance(), candidates);
+        erase_if(candidates, [&](const int id_2) { return is_done[id_2]; });
+        shuffle(candidates.begin(), candidates.end(), mt_);
 
-    for (const auto id_1 : list_1) {
-        for (const auto id_2 : list_2) {
+        for (const auto id_2 : candidates) {
             /* 順に接続する */
             pairDevices(id_1, id_2);
             connectDevices(id_1, id_2);
         }
 
-        /* 接続が完了したデバイスをリストから除外する */
-        auto itr = find(list_2.begin(), list_2.end(), id_1);
-        list_2.erase(itr);
-        shuffle(list_2.begin(), list_2.end(), mt_);
+        /* 接続が完了したデバイスを候補から除外する */
+        is_done[id_1] = true;
     }
 }
 
@@ -399,9 +548,15 @@ void DeviceManager::buildNetworkByDistance() {
         disconnectDevices(id);
     }
 
+    buildGrid();
+    /* 近傍候補 */
+    vector<int> candidates;
+
     for (auto id_1 : list) {
-        for (auto id_2 : list) {
-            /* 順にペアリングする */
+        /* 接続可能距離内のデバイスと順にペアリングする */
+        auto [pos_x, pos_y] = getPosition(id_1);
+        grid_.getNeighbors(pos_x, pos_y, getMaxComDistance(), candidates);
+        for (auto id_2 : candidates) {
             pairDevices(id_1, id_2);
         }
     }
@@ -412,7 +567,8 @@ void DeviceManager::buildNetworkByDistance() {
         map<double, int, greater<double>> tmp;
         transform(id_pairs.begin(), id_pairs.end(), inserter(tmp, tmp.begin()),
                   [&](const int id_2) -> pair<double, int> {
-                      return {getDistance(id_1, id_2), id_2};
+                      /* 距離の順は2乗の順と同じ */
+                      return {getSquaredDistance(id_1, id_2), id_2};
                   });
         for (auto [_, id_2] : tmp) {
             /* 遠い順に接続する */
@@ -468,6 +624,131 @@ void DeviceManager::makeMPR() {
     }
 }
 
+/*!
+ * @brief 接続グラフから全デバイスの MPR 集合をまとめて選ぶ
+ * @details hello を交換せずに接続グラフのスナップショットから選ぶ。
+ *          隣接デバイスの優先度はシミュレーションモードに従い、
+ *          makeMPR と同じく willingness または距離とする。
+ * @param heuristic 選択方式 (IN_ORDER なら makeMPR と同じ集合になる)
+ * @param pool デバイスごとの選択を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ * @return vector<vector<int>> デバイスID順の MPR 集合 (ID昇順)
+ */
+vector<vector<int>> DeviceManager::selectMPR(
+    const MPRSelector::Heuristic heuristic, ThreadPool *pool) {
+    return (this->*select_MPR_)(heuristic, pool);
+}
+
+/*!
+ * @brief 接続の変化に合わせて MPR 集合と経路表を部分的に修復する
+ * @details 切断した接続を経由していた経路を、それに依存する下流の経路まで
+ *          含めて無効にする。同じホップ数で届く隣接デバイス (隣接デバイスが
+ *          最後に広告した距離が1つ小さいもの) があれば付け替え、残った宛先は
+ *          有効な経路を持つ隣接デバイスに広告し直させる。新たに接続した
+ *          デバイス同士は経路表を丸ごと交換させる。MPR 集合は2ホップ隣接が
+ *          変わったデバイスだけ選び直し、2ホップ隣接の記録も接続グラフから
+ *          作り直す (LINK_STATE 方式の経路計算に使う)。この後 sendTable() と
+ *          makeTable() を更新がなくなるまで繰り返すと、前回の経路表から
+ *          再収束する。
+ * @param changes 変化した接続 (updatePositionAll() の戻り値)
+ * @return int 付け替えられず無効のまま残ったエントリ数
+ */
+int DeviceManager::repairNetwork(const vector<LinkChange> &changes) {
+    /* 変化後の接続グラフ */
+    const auto &graph = getGraph();
+    /* 無効にした経路 (デバイスID, 宛先ID) を無効前のホップ数ごとに分ける */
+    vector<vector<pair<int, int>>> invalidated_by_hop;
+    /* 無効にした経路に依存する経路を探すスタック */
+    vector<int> stack;
+
+    auto invalidate = [&](const int id, const int id_dest) {
+        /* 無効にしてもホップ数はエントリに残る */
+        const int num_hop = nodes_[id].getTable().getNumHop(id_dest);
+        if (num_hop >= static_cast<int>(invalidated_by_hop.size())) {
+            invalidated_by_hop.resize(num_hop + 1);
+        }
+        invalidated_by_hop[num_hop].emplace_back(id, id_dest);
+    };
+
+    for (const auto &[id_1, id_2, is_up] : changes) {
+        if (is_up) {
+            continue;
+        }
+        for (const auto &[id_from, id_to] : {pair{id_1, id_2}, {id_2, id_1}}) {
+            for (const auto id_dest : nodes_[id_from].linkDown(id_to)) {
+                /* 切断した接続を経由していた経路と、その下流を無効にする */
+                invalidate(id_from, id_dest);
+                stack.assign(1, id_from);
+                while (!stack.empty()) {
+                    const int id = stack.back();
+                    stack.pop_back();
+                    for (const auto id_cnct : graph.getNeighbors(id)) {
+                        if (nodes_[id_cnct].invalidateRoute(id_dest, id)) {
+                            invalidate(id_cnct, id_dest);
+                            stack.push_back(id_cnct);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* 付け替えられず無効のまま残った経路 */
+    vector<pair<int, int>> invalidated;
+    for (int num_hop = 0; num_hop < static_cast<int>(invalidated_by_hop.size());
+         num_hop++) {
+        /* 宛先に近い経路から付け替え、付け替えた経路を下流の付け替え先にする */
+        for (const auto &[id, id_dest] : invalidated_by_hop[num_hop]) {
+            bool is_rerouted = false;
+            for (const auto id_cnct : graph.getNeighbors(id)) {
+                /* 1ホップ近い有効な経路を持つ隣接デバイスに付け替える */
+                /* 自身より近いので、その経路が自身を通ることはない */
+                const auto &table_cnct = nodes_[id_cnct].getTable();
+                if (table_cnct.isEntryValid(id_dest) &&
+                    table_cnct.getNumHop(id_dest) == num_hop - 1) {
+                    is_rerouted =
+                        nodes_[id].rerouteRoute(id_dest, id_cnct, num_hop);
+                    break;
+                }
+            }
+            if (!is_rerouted) {
+                invalidated.emplace_back(id, id_dest);
+            }
+        }
+    }
+
+    for (const auto &[id_1, id_2, is_up] : changes) {
+        if (is_up) {
+            /* 新たに接続したデバイス同士の経路を登録する */
+            nodes_[id_1].linkUp(id_2);
+            nodes_[id_2].linkUp(id_1);
+        }
+    }
+
+    for (const auto &[id, id_dest] : invalidated) {
+        for (const auto id_cnct : graph.getNeighbors(id)) {
+            /* 無効なままの宛先への有効な経路を持つ隣接デバイスが広告し直す */
+            nodes_[id_cnct].refreshRoute(id_dest);
+        }
+    }
+
+    /* 2ホップ隣接が変わったデバイス (変化した接続の両端とその隣接) */
+    vector<int> ids;
+    for (const auto &[id_1, id_2, _] : changes) {
+        for (const auto id : {id_1, id_2}) {
+            ids.push_back(id);
+            const auto &id_cncts = nodes_[id].getIdConnectedDevices();
+            ids.insert(ids.end(), id_cncts.begin(), id_cncts.end());
+        }
+    }
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+
+    (this->*reselect_MPR_)(ids);
+
+    return invalidated.size();
+}
+
 /*!
  * @brief MPR集合を出力する
  * @param id デバイスID
@@ -476,8 +757,8 @@ void DeviceManager::showMPR(const int id) {
     /* 出力モード */
     WriteMode write_mode = WriteMode::ARRAY;
 
-    auto device_target = getDeviceById(id);
-    auto id_cncts = device_target.getIdConnectedDevices();
+    auto &device_target = getDeviceById(id);
+    const auto &id_cncts = device_target.getIdConnectedDevices();
     auto id_MPRs = device_target.getMPR();
 
     switch (write_mode) {
@@ -531,7 +812,7 @@ void DeviceManager::showMPR(const int id) {
             continue;
         }
 
-        auto dev_cnct = getDeviceById(id_cnct);
+        auto &dev_cnct = getDeviceById(id_cnct);
         switch (write_mode) {
             case WriteMode::VISIBLE:
                 std::cout << dev_cnct.getName() << [&] {
@@ -575,12 +856,10 @@ void DeviceManager::showMPR(const int id) {
 }
 
 int DeviceManager::getCentralDevice() {
-    auto list = getDevicesList();
     double center = field_size_ / 2;
 
-    for (auto id : list) {
-        const auto [pos_x, pos_y] = getPosition(id);
-        double location = hypot(pos_x - center, pos_y - center);
+    for (int id = 0; id < getNumDevices(); id++) {
+        double location = hypot(pos_x_[id] - center, pos_y_[id] - center);
         if (location < 5) {
             return id;
         }
@@ -591,16 +870,38 @@ int DeviceManager::getCentralDevice() {
 
 /*!
  * @brief すべてのデバイスにルーティングテーブルを作成させる
+ * @details LINK_STATE 方式では、TC の取り込みをデバイスごとに順に行って
+ *          から、経路を求め直すデバイスの探索を並列に実行する。
+ * @param pool 経路の探索を並列実行するスレッドプール (nullptr なら逐次)
  * @return int 更新ありデバイス数
  */
-int DeviceManager::makeTable() {
+int DeviceManager::makeTable(ThreadPool *pool) {
     int result = 0;
 
-    for (auto id : getDevicesList()) {
-        /* 順に作成させる */
-        result += static_cast<int>(getDeviceById(id).makeTable());
+    if (context_.getRoutingMode() !=
+        SimulationContext::RoutingMode::LINK_STATE) {
+        for (auto id : getDevicesList()) {
+            /* 順に作成させる */
+            result += static_cast<int>(getDeviceById(id).makeTable());
+        }
+
+        return result;
+    }
+
+    /* 経路を求め直すか (TC の取り込みはアリーナを使うので逐次) */
+    vector<bool> should_update(getNumDevices(), false);
+    for (int id = 0; id < getNumDevices(); id++) {
+        should_update[id] = nodes_[id].updateTopology();
+        result += static_cast<int>(should_update[id] ||
+                                   nodes_[id].hasTopologyControlToRelay());
     }
 
+    forEachDevice(pool, [&](const int id) {
+        if (should_update[id]) {
+            nodes_[id].makeTableFromTopology();
+        }
+    });
+
     return result;
 }
 
@@ -609,6 +910,28 @@ int DeviceManager::makeTable() {
  * @return vector<map<int, double>> 領域別平均度数分布
  */
 vector<map<int, double>> DeviceManager::calculateTableFrequency() {
+    return averageFrequencyByZone(
+        [&](const int id) { return nodes_[id].calculateTableFrequency(); });
+}
+
+/*!
+ * @brief 全点対ホップ数行列から収束後の度数分布を集計する
+ * @param hop_matrix 現在の接続グラフの全点対ホップ数行列
+ * @return vector<map<int, double>> 領域別平均度数分布
+ */
+vector<map<int, double>> DeviceManager::calculateTableFrequency(
+    const HopMatrix &hop_matrix) {
+    return averageFrequencyByZone(
+        [&](const int id) { return hop_matrix.calculateFrequency(id); });
+}
+
+/*!
+ * @brief デバイスごとの度数分布を領域別に平均する
+ * @param frequency_of デバイスIDから度数分布を得る処理
+ * @return vector<map<int, double>> 領域別平均度数分布
+ */
+vector<map<int, double>> DeviceManager::averageFrequencyByZone(
+    const function<map<int, int>(int)> &frequency_of) {
     /* 度数分布 */
     map<int, double> frequency_central, frequency_middle, frequency_edge;
     /* 分布するデバイス数 */
@@ -631,14 +954,12 @@ vector<map<int, double>> DeviceManager::calculateTableFrequency() {
         }
     };
 
-    for (auto id : getDevicesList()) {
+    for (int id = 0; id < getNumDevices(); id++) {
         /* 順に集計する */
-        auto frequency_device = getDeviceById(id).calculateTableFrequency();
+        auto frequency_device = frequency_of(id);
 
-        /* 座標 */
-        const auto [pos_x, pos_y] = getPosition(id);
         /* 中心点からの距離 */
-        double location = hypot(pos_x - center, pos_y - center);
+        double location = hypot(pos_x_[id] - center, pos_y_[id] - center);
 
         if (location < radius_central) {
             /* 中央部にあれば */
@@ -670,22 +991,167 @@ vector<map<int, double>> DeviceManager::calculateTableFrequency() {
     return {frequency_central, frequency_middle, frequency_edge};
 }
 
+/*!
+ * @brief 各デバイスを始点とする幅優先探索で、収束後の経路表を直接作成する
+ * @details パケットを交換せずに、sendTable/makeTable を収束まで繰り返した
+ *          場合と同じホップ数の経路表を得る。次ホップは最短経路上の隣接
+ *          デバイスのうち、探索で最初に見つかったものとする。
+ * @param pool 始点ごとの探索を並列実行するスレッドプール (nullptr なら逐次)
+ */
+void DeviceManager::makeTableByBfs(ThreadPool *pool) {
+    /* 接続グラフ */
+    const auto &graph = getGraph();
+
+    forEachDevice(pool, [&](const int id_source) {
+        /* 始点からのホップ数と最初のホップ */
+        vector<int> num_hop, id_first_hop;
+        searchHop(graph, id_source, num_hop, id_first_hop);
+
+        Table table;
+        for (int id_dest = 0; id_dest < getNumDevices(); id_dest++) {
+            if (num_hop[id_dest] > 0) {
+                /* 到達できる自身以外のデバイスを登録する */
+                table.setEntry(id_dest, id_first_hop[id_dest],
+                               num_hop[id_dest]);
+            }
+        }
+        nodes_[id_source].setTable(move(table));
+    });
+}
+
+/*!
+ * @brief 各デバイスの経路表を幅優先探索の結果と照合する
+ * @details 宛先ごとに探索し、ホップ数が最短であることと、次ホップが宛先に
+ *          1ホップ近づく接続中のデバイスであることを確認する。
+ * @param pool 宛先ごとの照合を並列実行するスレッドプール (nullptr なら逐次)
+ * @return int 誤ったエントリ数 (欠落・余剰を含む)
+ */
+int DeviceManager::verifyTable(ThreadPool *pool) {
+    /* 接続グラフ */
+    const auto &graph = getGraph();
+    /* 宛先ごとの誤ったエントリ数 */
+    vector<int> num_mismatch(getNumDevices(), 0);
+
+    forEachDevice(pool, [&](const int id_dest) {
+        /* 宛先からのホップ数 (無向グラフなので各デバイスから宛先への距離) */
+        vector<int> num_hop, id_first_hop;
+        searchHop(graph, id_dest, num_hop, id_first_hop);
+
+        for (int id = 0; id < getNumDevices(); id++) {
+            const auto &table = nodes_[id].getTable();
+            if (num_hop[id] <= 0) {
+                /* 自身と到達できない宛先は有効なエントリがあれば誤り */
+                num_mismatch[id_dest] += table.isEntryValid(id_dest);
+                continue;
+            }
+
+            auto id_nexthop = table.getIdNextHop(id_dest);
+            if (!table.isEntryValid(id_dest) ||
+                table.getNumHop(id_dest) != num_hop[id] ||
+                !graph.isAdjacent(id, id_nexthop) ||
+                num_hop[id_nexthop] != num_hop[id] - 1) {
+                ++num_mismatch[id_dest];
+            }
+        }
+    });
+
+    return reduce(num_mismatch.begin(), num_mismatch.end());
+}
+
+/*!
+ * @brief 現在の接続グラフの全点対ホップ数行列を作成する
+ * @param pool 探索を並列実行するスレッドプール (nullptr なら逐次)
+ * @return HopMatrix 全点対ホップ数行列
+ */
+HopMatrix DeviceManager::makeHopMatrix(ThreadPool *pool) {
+    return HopMatrix(getGraph(), pool);
+}
+
+/*!
+ * @brief 事象駆動で hello から経路表の収束までを実行する
+ * @details すべてのノードが時刻0に hello を送信し、hello が揃ったノードから
+ *          MPR を選んで経路表を広告する。以降は経路表が更新されたノードだけが
+ *          処理遅延の後に広告する。
+ * @param scheduler スケジューラ
+ * @return double 最後に経路表が更新された時刻[ms] (収束時間)
+ */
+double DeviceManager::makeTableEventDriven(EventScheduler &scheduler) {
+    context_.setScheduler(&scheduler);
+
+    for (auto &node : nodes_) {
+        /* 順に hello の送信を予約する */
+        node.sendHello();
+    }
+    scheduler.run();
+
+    context_.setScheduler(nullptr);
+
+    return scheduler.getTimeLastProgress();
+}
+
+/*!
+ * @brief 事象駆動でフラッディングを実行する
+ * @param id 開始デバイスのID
+ * @param scheduler スケジューラ
+ * @return pair<int, double> データ到達台数, 最後に到達した時刻[ms]
+ */
+pair<int, double> DeviceManager::floodingEventDriven(
+    const int id, EventScheduler &scheduler) {
+    if (!hasDevice(id)) {
+        /* デバイスが存在しなければ終了 */
+        return {0, 0.0};
+    }
+
+    context_.setScheduler(&scheduler);
+
+    auto &device_starter = getDeviceById(id);
+    device_starter.flooding(-1);
+    size_t data_id = device_starter.makeFloodData();
+    device_starter.flooding();
+    scheduler.run();
+
+    context_.setScheduler(nullptr);
+
+    return {aggregateDevices(data_id), scheduler.getTimeLastProgress()};
+}
+
+/*!
+ * @brief ネットワークが連結か (孤立するノードがないか) 取得
+ * @retval true 連結
+ * @retval false 非連結
+ */
+bool DeviceManager::isConnectedGraph() {
+    return makeUnionFind().getNumSets() <= 1;
+}
+
+/*!
+ * @return vector<int> 連結成分ごとのデバイス数 (降順)
+ */
+vector<int> DeviceManager::getComponentSizes() {
+    return makeUnionFind().getSetSizes();
+}
+
 /*!
  * @brief フラッディングを開始する
+ * @details 再送の有無はコンテキストのフラッディングモードに従う。
+ *          MPR モードでは到達しなかったデバイスが再送することもあるので、
+ *          到達台数ではなく送信が止まるまで繰り返す。
  * @param id 開始デバイスのID
- * @return pair<size_t, int> データ識別子, データ到達台数
+ * @return FloodingResult 送信パケット数, 重複受信数, 到達台数など
  */
-pair<size_t, int> DeviceManager::flooding(const int id) {
+DeviceManager::FloodingResult DeviceManager::flooding(const int id) {
     /* 出力モード */
     WriteMode write_mode = WriteMode::HIDE;
 
-    if (!nodes_.count(id)) {
+    if (!hasDevice(id)) {
         /* デバイスが存在しなければ終了 */
-        return {0, 0};
+        return {0, 0, 0, 0, 0};
     }
 
     auto &device_starter = getDeviceById(id);
-    int num_devices_have_data = 0, num_step = 0;
+    int num_step = 0;
+    /* 開始時の累計パケット数 */
+    const int num_packet_start = context_.getTotalPacket();
 
     device_starter.flooding(-1);
 
@@ -704,15 +1170,19 @@ pair<size_t, int> DeviceManager::flooding(const int id) {
             break;
     }
 
-    while (num_devices_have_data !=
-           aggregateDevices(data_id, devices_have_data, write_mode)) {
-        /* フラッディングが止まるまで繰り返す */
-        num_devices_have_data = devices_have_data.size();
+    while (true) {
+        aggregateDevices(data_id, devices_have_data, write_mode);
+        /* このホップの開始時の累計パケット数 */
+        const int num_packet_step = context_.getTotalPacket();
 
-        for (auto &[_, device] : nodes_) {
+        for (auto &device : nodes_) {
             /* 順にフラッディングをさせる */
             device.flooding();
         }
+        if (context_.getTotalPacket() == num_packet_step) {
+            /* 誰も送信しなければフラッディングは止まった */
+            break;
+        }
 
         num_step++;
         device_starter.flooding(1);
@@ -734,7 +1204,105 @@ pair<size_t, int> DeviceManager::flooding(const int id) {
                   << endl;
     }
 
-    return {data_id, devices_have_data.size()};
+    /* 送信パケット数 */
+    const int num_transmissions = context_.getTotalPacket() - num_packet_start;
+    /* データ到達台数 */
+    const int num_reach = devices_have_data.size();
+
+    /* 送信は接続中のデバイスにだけ行うので必ず1台が受信する。
+       開始デバイス以外の初回受信を除いた残りが重複受信になる */
+    return {data_id, num_transmissions, num_transmissions - (num_reach - 1),
+            num_reach, num_step};
+}
+
+/*!
+ * @brief 接続グラフ上で複数の始点からのフラッディングを同時に進める
+ * @details デバイスのメモリを使わず、フラッディングごとのビット集合と
+ *          フロンティアで進める。再送の有無はコンテキストのフラッディング
+ *          モードに従い、MPR モードでは各デバイスの MPR 集合を使う。
+ *          送信パケット数などは始点ごとの flooding と一致する。
+ * @param id_sources 開始デバイスのID
+ * @param pool フラッディングごとの処理を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ * @return vector<FloodingEngine::Result> 開始デバイス順のフラッディング結果
+ *         (存在しないデバイスは到達台数 0)
+ */
+vector<FloodingEngine::Result> DeviceManager::floodingByFrontier(
+    const vector<int> &id_sources, ThreadPool *pool) {
+    /* フラッディングエンジン */
+    auto engine = FloodingEngine(getGraph(), collectFloodingMPR());
+    /* 開始デバイス順のフラッディングの番号 (存在しなければ -1) */
+    vector<int> indices;
+    for (const auto id : id_sources) {
+        indices.push_back(hasDevice(id) ? engine.start(id) : -1);
+    }
+    engine.run(pool);
+
+    vector<FloodingEngine::Result> results;
+    for (int i = 0; i < static_cast<int>(id_sources.size()); i++) {
+        if (indices[i] < 0) {
+            results.push_back({id_sources[i], 0, 0, 0, 0, {}});
+            continue;
+        }
+        results.push_back(engine.getResult(indices[i]));
+    }
+
+    return results;
+}
+
+/*!
+ * @brief すべてのデバイスを始点とするフラッディングを一括で行う
+ * @details 始点をビットに割り当てて同時に進めるので、始点ごとに flooding を
+ *          繰り返すより速い。再送の有無はコンテキストのフラッディングモードに
+ *          従う。結果は始点ごとの flooding と一致する。
+ * @param pool 始点のまとまりごとの処理を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ * @return vector<FloodingEngine::Result> デバイスID順のフラッディング結果
+ *         (ホップごとの到達台数と送信パケット数を含む)
+ */
+vector<FloodingEngine::Result> DeviceManager::floodingFromAll(
+    ThreadPool *pool) {
+    return FloodingEngine(getGraph(), collectFloodingMPR()).floodAll(pool);
+}
+
+/*!
+ * @brief フラッディングでホップごとに新たに到達したデバイスを取得
+ * @details 再送の有無はコンテキストのフラッディングモードに従う。
+ *          makeFloodingGif.py で描画する記録に使う。
+ * @param id 開始デバイスID
+ * @return vector<vector<int>> 1ホップ目からのホップごとに新たに到達した
+ *         デバイスID (昇順, 存在しないIDなら空)
+ */
+vector<vector<int>> DeviceManager::getReachedPerHop(const int id) {
+    vector<vector<int>> reached_per_hop;
+    if (!hasDevice(id)) {
+        return reached_per_hop;
+    }
+
+    auto engine = FloodingEngine(getGraph(), collectFloodingMPR());
+    const int index = engine.start(id);
+    /* 到達済みのデバイス */
+    set<int> devices_have_data{id};
+
+    bool is_active = true;
+    while (is_active) {
+        const int num_step = engine.getResult(index).num_step;
+        is_active = engine.step();
+        if (engine.getResult(index).num_step == num_step) {
+            /* 送信がなかった */
+            continue;
+        }
+
+        auto &reached = reached_per_hop.emplace_back();
+        for (const auto id_device : getDevicesList()) {
+            if (engine.hasData(index, id_device) &&
+                devices_have_data.insert(id_device).second) {
+                reached.push_back(id_device);
+            }
+        }
+    }
+
+    return reached_per_hop;
 }
 
 /*!
@@ -745,7 +1313,7 @@ pair<size_t, int> DeviceManager::flooding(const int id) {
 int DeviceManager::aggregateDevices(size_t data_id) {
     int cnt = 0;
 
-    for (auto &[_, device] : nodes_) {
+    for (auto &device : nodes_) {
         if (device.hasData(data_id)) {
             cnt++;
         }
@@ -763,8 +1331,9 @@ int DeviceManager::aggregateDevices(size_t data_id) {
  */
 int DeviceManager::aggregateDevices(size_t data_id, set<int> &devices_have_data,
                                     const WriteMode write_mode) {
-    for (auto &[id, device] : nodes_) {
+    for (auto &device : nodes_) {
         /* 順にデータを持っているか確認する */
+        const int id = device.getId();
         if (devices_have_data.count(id)) {
             /* すでにカウント済みならスルー */
             continue;
@@ -824,12 +1393,240 @@ void DeviceManager::unicast(const int id_source, const int id_dest) {
 }
 
 /*!
- * @brief IDに合致するバイアスを参照 (不正なIDではないか事前確認)
+ * @brief デバイスが存在するか取得
  * @param id デバイスID
- * @return デバイスのバイアスの参照
+ * @retval true 存在する
+ * @retval false 存在しない
+ */
+bool DeviceManager::hasDevice(const int id) const {
+    return 0 <= id && id < getNumDevices();
+}
+
+/*!
+ * @brief 現在の座標から空間インデックスを構築する
+ */
+void DeviceManager::buildGrid() {
+    grid_ = SpatialGrid(field_size_, getMaxComDistance());
+    grid_.build(pos_x_, pos_y_);
+}
+
+/*!
+ * @brief 距離内のデバイス対を接続し直す
+ * @param candidates 距離内のデバイス対 (ID1 < ID2, 重複可, 並べ替えられる)
+ * @param changes 接続の変化の格納先 (追記される)
+ */
+void DeviceManager::repairConnections(vector<pair<int, int>> &candidates,
+                                      vector<LinkChange> &changes) {
+    (this->*repair_connections_)(candidates, changes);
+}
+
+/*!
+ * @brief シミュレーションモードの方針に従って距離内のデバイス対を接続し直す
+ * @details 接続順は方針に合わせ、buildNetworkRandom() と同様にランダム、
+ *          または buildNetworkByDistance() と同様に遠い順とする
+ * @tparam Policy シミュレーションモードの方針
+ * @param candidates 距離内のデバイス対 (ID1 < ID2, 重複可, 並べ替えられる)
+ * @param changes 接続の変化の格納先 (追記される)
  */
-pair<double, double> &DeviceManager::getBias(const int id) {
-    return nodes_.at(id).getBias();
+template <class Policy>
+void DeviceManager::repairConnectionsWith(vector<pair<int, int>> &candidates,
+                                          vector<LinkChange> &changes) {
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    if constexpr (Policy::IS_FAR_FIRST) {
+        /* 遠い順 */
+        stable_sort(candidates.begin(), candidates.end(),
+                    [&](const pair<int, int> &left,
+                        const pair<int, int> &right) {
+                        return getDistance(left.first, left.second) >
+                               getDistance(right.first, right.second);
+                    });
+    } else {
+        shuffle(candidates.begin(), candidates.end(), mt_);
+    }
+
+    for (const auto &[id_1, id_2] : candidates) {
+        if (isConnected(id_1, id_2)) {
+            /* 接続済みなら次へ */
+            continue;
+        }
+        if (!getDeviceById(id_1).hasFreeConnection() ||
+            !getDeviceById(id_2).hasFreeConnection()) {
+            /* どちらかの接続枠が埋まっていれば接続できない */
+            continue;
+        }
+        /* 順に接続する */
+        pairDevices(id_1, id_2);
+        connectDevices(id_1, id_2);
+        if (isConnected(id_1, id_2)) {
+            changes.push_back({id_1, id_2, true});
+        }
+    }
+}
+
+/*!
+ * @brief 現在の接続関係から接続グラフのスナップショットを作る
+ */
+void DeviceManager::buildGraph() {
+    graph_.build(getNumDevices(), [&](const int id) {
+        return nodes_[id].getIdConnectedDevices();
+    });
+    is_graph_stale_ = false;
+}
+
+/*!
+ * @brief 接続関係から素集合データ構造を作る
+ * @return UnionFind 連結成分ごとにまとめた素集合
+ */
+UnionFind DeviceManager::makeUnionFind() {
+    /* 接続グラフ */
+    const auto &graph = getGraph();
+
+    UnionFind components(getNumDevices());
+    for (int id = 0; id < getNumDevices(); id++) {
+        for (auto id_cnct : graph.getNeighbors(id)) {
+            /* 接続中のデバイスと同じ集合にする */
+            components.unite(id, id_cnct);
+        }
+    }
+
+    return components;
+}
+
+/*!
+ * @brief 1つの始点から幅優先探索でホップ数を求める
+ * @param graph 接続グラフ
+ * @param id_source 始点デバイスのID
+ * @param num_hop 各デバイスまでのホップ数 (到達できなければ -1)
+ * @param id_first_hop 各デバイスへの最短経路で最初に通る隣接デバイス
+ */
+void DeviceManager::searchHop(const ConnectionGraph &graph,
+                              const int id_source, vector<int> &num_hop,
+                              vector<int> &id_first_hop) const {
+    num_hop.assign(graph.getNumNodes(), -1);
+    id_first_hop.assign(graph.getNumNodes(), -1);
+
+    /* 探索キュー (訪問順に並べ、先頭位置を進める) */
+    vector<int> queue{id_source};
+    queue.reserve(graph.getNumNodes());
+    num_hop[id_source] = 0;
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        const auto id = queue[head];
+        for (const auto id_next : graph.getNeighbors(id)) {
+            if (num_hop[id_next] >= 0) {
+                /* 訪問済みならスキップ */
+                continue;
+            }
+            num_hop[id_next] = num_hop[id] + 1;
+            id_first_hop[id_next] =
+                id == id_source ? id_next : id_first_hop[id];
+            queue.push_back(id_next);
+        }
+    }
+}
+
+/*!
+ * @brief すべてのデバイスIDについて処理を実行する
+ * @param pool 並列実行するスレッドプール (nullptr なら逐次)
+ * @param task デバイスIDを受け取る処理
+ */
+void DeviceManager::forEachDevice(ThreadPool *pool,
+                                  const function<void(int)> &task) {
+    if (pool == nullptr) {
+        for (int id = 0; id < getNumDevices(); id++) {
+            task(id);
+        }
+        return;
+    }
+
+    pool->parallelFor(getNumDevices(), task);
+}
+
+/*!
+ * @brief シミュレーションモードの方針に従って MPR 選択の優先度を作る
+ * @details makeMPR と同じく方針の優先度 (willingness または距離) を使う。
+ *          距離は方針が使うときだけ求める。
+ * @tparam Policy シミュレーションモードの方針
+ * @return (デバイス, 隣接デバイス) から隣接デバイスの優先度を得る処理
+ */
+template <class Policy>
+auto DeviceManager::makeMPRPriorityWith() const {
+    return [this](const int id, const int id_neighbor) {
+        return Policy::getMPRPriority(willingness_[id_neighbor], [&] {
+            return getDistance(id, id_neighbor);
+        });
+    };
+}
+
+/*!
+ * @brief シミュレーションモードの方針に従って全デバイスの MPR 集合を選ぶ
+ * @tparam Policy シミュレーションモードの方針
+ * @param heuristic 選択方式
+ * @param pool デバイスごとの選択を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ * @return vector<vector<int>> デバイスID順の MPR 集合 (ID昇順)
+ */
+template <class Policy>
+vector<vector<int>> DeviceManager::selectMPRWith(
+    const MPRSelector::Heuristic heuristic, ThreadPool *pool) {
+    return MPRSelector(getGraph())
+        .selectAll(heuristic, makeMPRPriorityWith<Policy>(), pool);
+}
+
+/*!
+ * @brief シミュレーションモードの方針に従って MPR 集合を選び直す
+ * @details makeMPR と同じ集合になる方式で選び、2ホップ隣接の記録も
+ *          接続グラフから作り直す
+ * @tparam Policy シミュレーションモードの方針
+ * @param ids 選び直すデバイスのID
+ */
+template <class Policy>
+void DeviceManager::reselectMPRWith(const vector<int> &ids) {
+    /* 接続グラフ */
+    const auto &graph = getGraph();
+    const MPRSelector selector(graph);
+    const auto priority_of = makeMPRPriorityWith<Policy>();
+    /* 2ホップ隣接 <2ホップ隣接のID, 経由する MPR のID> */
+    map<int, int> tow_hop_neighbors;
+    for (const auto id : ids) {
+        const auto MPRs =
+            selector.select(id, MPRSelector::Heuristic::IN_ORDER, priority_of);
+        tow_hop_neighbors.clear();
+        for (const auto id_MPR : MPRs) {
+            for (const auto id_tow_hop : graph.getNeighbors(id_MPR)) {
+                /* MPR 集合はすべての2ホップ隣接を覆う */
+                if (id_tow_hop != id && !graph.isAdjacent(id, id_tow_hop)) {
+                    tow_hop_neighbors.emplace(id_tow_hop, id_MPR);
+                }
+            }
+        }
+        nodes_[id].setMPR(MPRs, tow_hop_neighbors);
+    }
+}
+
+/*!
+ * @brief フラッディングエンジンに渡す MPR 集合を集める
+ * @return vector<vector<int>> デバイスID順の MPR 集合
+ *         (フラッディングモードが MPR でなければ空)
+ */
+vector<vector<int>> DeviceManager::collectFloodingMPR() {
+    /* デバイスIDごとの MPR 集合 */
+    vector<vector<int>> MPRs;
+    if (context_.getFloodingMode() != SimulationContext::FloodingMode::MPR) {
+        /* ブラインドフラッディングなら MPR 集合は使わない */
+        return MPRs;
+    }
+
+    MPRs.resize(nodes_.size());
+    for (auto &node : nodes_) {
+        const auto MPR = node.getMPR();
+        MPRs[node.getId()].assign(MPR.begin(), MPR.end());
+    }
+
+    return MPRs;
 }
 
 /*!
@@ -875,10 +1672,7 @@ bool DeviceManager::isConnected(const int id_1, const int id_2) {
  * @param willingness willingness
  */
 DeviceManager::Node::Node(const int id, const int willingness, MGR *manager)
-    : Device{id, willingness},
-      bias_{0.0, 0.0},
-      position_{0.0, 0.0},
-      manager_{manager} {}
+    : Device{id, willingness, manager->getContext()}, manager_{manager} {}
 
 /*!
  * @brief デバイス名を取得(オーバーライド)
@@ -891,112 +1685,73 @@ string DeviceManager::Node::getName() {
 }
 
 /*!
- * @return 移動バイアス
- */
-pair<double, double> &DeviceManager::Node::getBias() { return bias_; }
-
-/*!
- * @return 座標
- */
-pair<double, double> &DeviceManager::Node::getPosition() { return position_; }
-
-/*!
- * @brief バイアスを設定
- * @param bias_x x成分
- * @param bias_y y成分
- */
-void DeviceManager::Node::setBias(double bias_x, double bias_y) {
-    bias_ = {bias_x, bias_y};
-}
-
-/*!
- * @brief 座標を設定
- * @param pos_x x座標
- * @param pos_y y座標
+ * @brief MPR集合を作成する(オーバーライド)
  */
-void DeviceManager::Node::setPositon(double pos_x, double pos_y) {
-    position_ = {pos_x, pos_y};
-}
+void DeviceManager::Node::makeMPR() { (this->*manager_->make_MPR_)(); }
 
 /*!
- * @brief MPR集合を作成する(オーバーライド)
+ * @brief シミュレーションモードの方針に従って MPR集合を作成する
+ * @tparam Policy シミュレーションモードの方針
  */
-void DeviceManager::Node::makeMPR() {
-    /* シミュレーションモード */
-    auto sim_mode = sim_mode_;
-
+template <class Policy>
+void DeviceManager::Node::makeMPRWith() {
     /* 隣接ノード構造体 */
     struct Neighbor {
         int id;
-        int willingness;
-        double distance;
+        double priority;
     };
 
     MPR_.clear();
     tow_hop_neighbors_.clear();
-    /* 隣接ノード <id, willingness, distance> (降順) */
+    /* 隣接ノード <id, 方針の優先度> (降順) */
     vector<Neighbor> neighbors;
 
     while (true) {
-        /* メモリ末尾から willingness 属性のデータを走査する */
-        auto itr = find_if(memory_.rbegin(), memory_.rend(),
-                           [](pair<size_t, Device::Sell> &&sell) {
-                               auto &[_, data_in_sell] = sell;
-                               return data_in_sell.getDataAttribute() ==
-                                      DataAttr::WILLINGNESS;
-                           });
-        if (itr == memory_.rend()) {
+        /* 最新の未処理 willingness 属性のデータ */
+        auto *sell = memory_->peekLatest(DataAttr::WILLINGNESS);
+        if (sell == nullptr) {
             /* 見つからなければループを離脱 */
             break;
         }
 
         /* 見つかったデータの保存場所 */
-        auto &[_, data_in_sell] = *itr;
+        auto &data_in_sell = *sell;
         /* 隣接ノードのデバイスID */
         auto id_neighbor = data_in_sell.getIdSender();
-        auto willingness = get<int>(data_in_sell.getData());
-
-        neighbors.emplace_back(id_neighbor, willingness,
-                               manager_->getDistance(getId(), id_neighbor));
+        auto willingness =
+            data_in_sell.template getMessage<DataAttr::WILLINGNESS>()
+                .willingness;
+
+        /* 距離は方針が使うときだけ求める */
+        neighbors.emplace_back(
+            id_neighbor, Policy::getMPRPriority(willingness, [&] {
+                return manager_->getDistance(getId(), id_neighbor);
+            }));
         table_.setEntry(id_neighbor, id_neighbor, 1);
 
-        data_in_sell.setDaTaAttribute(DataAttr::NONE);
+        memory_->consumeLatest(DataAttr::WILLINGNESS);
     }
 
-    /* neighbors を指標の降順にソート */
+    /* neighbors を方針の優先度の降順にソート */
     sort(neighbors.begin(), neighbors.end(),
-         [&](Neighbor &left, Neighbor &right) {
-             switch (sim_mode) {
-                 case Device::SimulationMode::CONVENTIONAL:
-                 case Device::SimulationMode::PROPOSAL_LONG_CONNECTION:
-                     /* 従来手法, 提案手法 遠距離接続 */
-                     return left.willingness > right.willingness;
-                 case Device::SimulationMode::PROPOSAL_LONG_MPR:
-                     /* 提案手法 遠距離MPR 没案 */
-                     return left.distance > right.distance;
-                 default:
-                     return false;
-             }
+         [](const Neighbor &left, const Neighbor &right) {
+             return left.priority > right.priority;
          });
 
-    for (auto [id_neighbor, _, __] : neighbors) {
+    for (auto [id_neighbor, _] : neighbors) {
         /* 隣接ノードのトポロジー情報から2ホップ隣接ノードをリスト化する */
-        /* メモリ末尾からトポロジー情報を走査する */
-        auto itr = find_if(memory_.rbegin(), memory_.rend(),
-                           [&](pair<size_t, Device::Sell> &&sell) {
-                               auto &[_, data_in_sell] = sell;
-                               return data_in_sell.getDataAttribute() ==
-                                          DataAttr::TOPOLOGY &&
-                                      data_in_sell.getIdSender() == id_neighbor;
-                           });
-        if (itr == memory_.rend()) {
+        /* 隣接ノードから受信したトポロジー情報 */
+        auto *sell = memory_->findTopology(id_neighbor);
+        if (sell == nullptr) {
             /* 見つからなければループを離脱 */
             break;
         }
         /* 見つかったデータの保存場所 */
-        auto &[___, data_in_sell] = *itr;
+        auto &data_in_sell = *sell;
 
-        for (auto id_neighbor_cncts = get<set<int>>(data_in_sell.getData());
+        for (const auto &id_neighbor_cncts =
+                 data_in_sell.template getMessage<DataAttr::TOPOLOGY>()
+                     .id_connected;
              auto id_tow_hop_neighbor : id_neighbor_cncts) {
             /* 隣接ノードが接続中のノードを順に2ホップ隣接のリストに挿入する */
             if (isSelf(id_tow_hop_neighbor)) {
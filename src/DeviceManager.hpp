@@ -8,36 +8,84 @@
 #ifndef DEVICEMANAGER_HPP
 #define DEVICEMANAGER_HPP
 
+#include <deque>
 #include <map>
 #include <random>
 #include <vector>
 
+#include "ConnectionGraph.hpp"
 #include "Device.hpp"
+#include "FloodingEngine.hpp"
+#include "HopMatrix.hpp"
+#include "MPRSelector.hpp"
+#include "NearPairList.hpp"
+#include "SimulationPolicy.hpp"
+#include "SpatialGrid.hpp"
+#include "ThreadPool.hpp"
+#include "UnionFind.hpp"
 using namespace std;
 
-/* 接続可能距離 */
-const double MAX_COM_DISTANCE = 10.0;
+/* 近傍ペアリストの余裕幅 (接続可能距離に対する比) */
+const double NEAR_PAIR_MARGIN_RATIO = 0.5;
 
 /* デバイスマネージャー クラス */
 class DeviceManager {
    public:
     /* シミュレーションモード列挙型 */
-    enum class SimulationMode;
+    using SimulationMode = SimulationContext::SimulationMode;
+    /* 接続の変化構造体 */
+    struct LinkChange;
+    /* フラッディング結果構造体 */
+    struct FloodingResult;
 
    private:
-    /* 接続可能距離 */
-    static double _max_com_distance_;
+    /* シミュレーションコンテキスト */
+    SimulationContext context_;
 
     /* フィールドサイズ */
     const double field_size_;
 
-    /* シミュレーションモード */
-    SimulationMode sim_mode_;
-
     /* ノード クラス */
     class Node;
-    /*すべてのデバイス */
-    map<int, Node> nodes_;
+    /* すべてのデバイスのプロトコル状態 (ID順, 参照が無効にならないよう deque) */
+    deque<Node> nodes_;
+
+    /* 以下 シミュレーションモードの方針で特殊化した処理 (setSimMode で選ぶ) */
+    /* ネットワーク構築 */
+    void (DeviceManager::*build_network_)();
+    /* 距離内のデバイス対の再接続 */
+    void (DeviceManager::*repair_connections_)(vector<pair<int, int>> &,
+                                               vector<LinkChange> &);
+    /* 接続グラフからの MPR 集合の選択 */
+    vector<vector<int>> (DeviceManager::*select_MPR_)(
+        const MPRSelector::Heuristic, ThreadPool *);
+    /* 指定したデバイスの MPR 集合の選び直し */
+    void (DeviceManager::*reselect_MPR_)(const vector<int> &);
+    /* デバイスの MPR 集合の作成 */
+    void (Node::*make_MPR_)();
+
+    /* 以下 ID を添字とする配置情報 (struct of arrays) */
+    /* 座標 x成分 */
+    vector<double> pos_x_;
+    /* 座標 y成分 */
+    vector<double> pos_y_;
+    /* 移動バイアス x成分 */
+    vector<double> bias_x_;
+    /* 移動バイアス y成分 */
+    vector<double> bias_y_;
+    /* willingness */
+    vector<int> willingness_;
+
+    /* 近傍探索用の空間インデックス */
+    SpatialGrid grid_;
+    /* 接続グラフのスナップショット */
+    ConnectionGraph graph_;
+    /* 接続が変わり、スナップショットが古くなったか */
+    bool is_graph_stale_;
+    /* 移動による接続の差分更新用の近傍ペアリスト */
+    NearPairList near_pairs_;
+    /* デバイスの増減で近傍ペアリストが古くなったか */
+    bool is_near_pairs_stale_;
 
     /* メルセンヌ・ツイスタ */
     mt19937 mt_;
@@ -55,16 +103,20 @@ class DeviceManager {
 
    public:
     DeviceManager(const double field_size);
+    DeviceManager(const double field_size, const unsigned int seed);
 
-    static double getMaxComDistance();
+    SimulationContext &getContext();
+    double getMaxComDistance() const;
 
     void setSimMode(const SimulationMode sim_mode);
 
     int getNumDevices() const;
     vector<int> getDevicesList() const;
     Node &getDeviceById(const int id);
-    pair<double, double> &getPosition(const int id);
-    double getDistance(const int id_1, const int id_2);
+    pair<double, double> getPosition(const int id) const;
+    double getDistance(const int id_1, const int id_2) const;
+    double getSquaredDistance(const int id_1, const int id_2) const;
+    const ConnectionGraph &getGraph();
 
     void addDevices(const int num_devices);
     void removeDevice(const int id);
@@ -77,7 +129,7 @@ class DeviceManager {
     void disconnectDevices(const int id);
 
     void updatePosition(const int id);
-    void updatePositionAll();
+    vector<LinkChange> updatePositionAll();
     void relocatePosition();
 
     void clearDevice();
@@ -91,13 +143,33 @@ class DeviceManager {
     void sendTable();
 
     void makeMPR();
+    vector<vector<int>> selectMPR(const MPRSelector::Heuristic heuristic,
+                                  ThreadPool *pool = nullptr);
+    int repairNetwork(const vector<LinkChange> &changes);
     void showMPR(const int id);
     int getCentralDevice();
 
-    int makeTable();
+    int makeTable(ThreadPool *pool = nullptr);
     vector<map<int, double>> calculateTableFrequency();
+    vector<map<int, double>> calculateTableFrequency(
+        const HopMatrix &hop_matrix);
+
+    void makeTableByBfs(ThreadPool *pool = nullptr);
+    int verifyTable(ThreadPool *pool = nullptr);
+    HopMatrix makeHopMatrix(ThreadPool *pool = nullptr);
+
+    double makeTableEventDriven(EventScheduler &scheduler);
+    pair<int, double> floodingEventDriven(const int id,
+                                          EventScheduler &scheduler);
 
-    pair<size_t, int> flooding(const int id);
+    bool isConnectedGraph();
+    vector<int> getComponentSizes();
+
+    FloodingResult flooding(const int id);
+    vector<FloodingEngine::Result> floodingByFrontier(
+        const vector<int> &id_sources, ThreadPool *pool = nullptr);
+    vector<FloodingEngine::Result> floodingFromAll(ThreadPool *pool = nullptr);
+    vector<vector<int>> getReachedPerHop(const int id);
     int aggregateDevices(size_t data_id);
     int aggregateDevices(size_t data_id, set<int> &devices_have_data,
                          const WriteMode write_mode);
@@ -105,7 +177,36 @@ class DeviceManager {
     void unicast(const int id_source, const int id_dest);
 
    private:
-    pair<double, double> &getBias(const int id);
+    bool hasDevice(const int id) const;
+
+    template <class Policy>
+    void bindPolicy();
+    template <class Policy>
+    void buildNetworkWith();
+    template <class Policy>
+    void repairConnectionsWith(vector<pair<int, int>> &candidates,
+                               vector<LinkChange> &changes);
+    template <class Policy>
+    auto makeMPRPriorityWith() const;
+    template <class Policy>
+    vector<vector<int>> selectMPRWith(const MPRSelector::Heuristic heuristic,
+                                      ThreadPool *pool);
+    template <class Policy>
+    void reselectMPRWith(const vector<int> &ids);
+
+    void buildGrid();
+    void buildGraph();
+    void repairConnections(vector<pair<int, int>> &candidates,
+                           vector<LinkChange> &changes);
+    UnionFind makeUnionFind();
+
+    void searchHop(const ConnectionGraph &graph, const int id_source,
+                   vector<int> &num_hop, vector<int> &id_first_hop) const;
+    void forEachDevice(ThreadPool *pool, const function<void(int)> &task);
+    vector<vector<int>> collectFloodingMPR();
+
+    vector<map<int, double>> averageFrequencyByZone(
+        const function<map<int, int>(int)> &frequency_of);
 
     bool isSameDevice(const int id_1, const int id_2) const;
     bool isPaired(const int id_1, const int id_2);
@@ -116,21 +217,27 @@ class DeviceManager {
 using MGR = DeviceManager;
 
 /* シミュレーションモード */
-enum class DeviceManager::SimulationMode {
-    NONE,
-    CONVENTIONAL,             /* 既存手法 */
-    PROPOSAL_LONG_CONNECTION, /* 提案手法 遠距離接続 */
-    PROPOSAL_LONG_MPR         /* 提案手法 遠距離MPR 没手法 */
-};
 using SIMMODE = DeviceManager::SimulationMode;
 
+/* 接続の変化 */
+struct DeviceManager::LinkChange {
+    int id_1;   /* デバイスID1 */
+    int id_2;   /* デバイスID2 */
+    bool is_up; /* true: 接続, false: 切断 */
+};
+
+/* フラッディング結果 */
+struct DeviceManager::FloodingResult {
+    size_t data_id;        /* データ識別子 */
+    int num_transmissions; /* 送信パケット数 */
+    int num_duplicates;    /* 重複受信数 */
+    int num_reach;         /* データ到達台数 (開始デバイスを含む) */
+    int num_step;          /* 送信が止まるまでのホップ数 */
+};
+
 /* ノード クラス */
 class DeviceManager::Node : public Device {
    private:
-    /* 移動バイアス */
-    pair<double, double> bias_;
-    /* 座標 */
-    pair<double, double> position_;
     /* マネージャー */
     MGR *manager_;
 
@@ -138,13 +245,10 @@ class DeviceManager::Node : public Device {
     Node(const int id, const int willingness, MGR *manager);
 
     string getName() override;
-    pair<double, double> &getBias();
-    pair<double, double> &getPosition();
-
-    void setBias(double bias_x, double bias_y);
-    void setPositon(double pos_x, double pos_y);
 
     void makeMPR() override;
+    template <class Policy>
+    void makeMPRWith();
 };
 
 /* 出力モード列挙型 */
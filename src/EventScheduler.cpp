@@ -0,0 +1,146 @@
+/*!
+ * @file EventScheduler.cpp
+ * @author tom96da
+ * @brief EventScheduler クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "EventScheduler.hpp"
+
+#include <utility>
+
+/* 離散事象シミュレーションのスケジューラクラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param link_latency リンク遅延[ms] デフォルト値: 1.0
+ * @param processing_delay ノードの処理遅延[ms] デフォルト値: 0.5
+ */
+EventScheduler::EventScheduler(const double link_latency,
+                               const double processing_delay)
+    : now_{0.0},
+      time_last_progress_{0.0},
+      num_scheduled_{0},
+      num_processed_{0},
+      link_latency_{[link_latency](int, int) { return link_latency; }},
+      processing_delay_{processing_delay} {}
+
+/*!
+ * @return double 現在時刻[ms]
+ */
+double EventScheduler::getNow() const { return now_; }
+
+/*!
+ * @return double 最後に状態が進展した時刻[ms]
+ */
+double EventScheduler::getTimeLastProgress() const {
+    return time_last_progress_;
+}
+
+/*!
+ * @return uint64_t 実行済み事象数
+ */
+uint64_t EventScheduler::getNumProcessed() const { return num_processed_; }
+
+/*!
+ * @brief 未実行の事象がないか取得
+ * @retval true 事象なし
+ * @retval false 事象あり
+ */
+bool EventScheduler::isEmpty() const { return events_.empty(); }
+
+/*!
+ * @param id_sender 送信元デバイスのID
+ * @param id_receiver 宛先デバイスのID
+ * @return double リンク遅延[ms]
+ */
+double EventScheduler::getLinkLatency(const int id_sender,
+                                      const int id_receiver) const {
+    return link_latency_(id_sender, id_receiver);
+}
+
+/*!
+ * @return double ノードの処理遅延[ms]
+ */
+double EventScheduler::getProcessingDelay() const { return processing_delay_; }
+
+/*!
+ * @brief リンクごとの遅延を設定する
+ * @param link_latency <送信元ID, 宛先ID> からリンク遅延[ms]を返す関数
+ */
+void EventScheduler::setLinkLatency(function<double(int, int)> link_latency) {
+    link_latency_ = std::move(link_latency);
+}
+
+/*!
+ * @brief 事象を登録する
+ * @param delay 現在時刻からの遅延[ms]
+ * @param action 処理内容
+ */
+void EventScheduler::schedule(const double delay, function<void()> action) {
+    events_.push(Event{now_ + delay, num_scheduled_++, std::move(action)});
+}
+
+/*!
+ * @brief 現在時刻を状態が進展した時刻として記録する
+ */
+void EventScheduler::markProgress() { time_last_progress_ = now_; }
+
+/*!
+ * @brief 最も早い事象を1つ実行する
+ * @retval true 実行した
+ * @retval false 事象がない
+ */
+bool EventScheduler::step() {
+    if (events_.empty()) {
+        return false;
+    }
+
+    /* 取り出した事象 (実行中に新たな事象が登録されるので先に外す) */
+    auto event = events_.top();
+    events_.pop();
+
+    now_ = event.time_;
+    ++num_processed_;
+    event.action_();
+
+    return true;
+}
+
+/*!
+ * @brief 事象がなくなるまで実行する
+ * @return double 終了時刻[ms]
+ */
+double EventScheduler::run() {
+    while (step()) {
+    }
+
+    return now_;
+}
+
+/*!
+ * @brief 時刻と事象をリセットする
+ */
+void EventScheduler::reset() {
+    events_ = {};
+    now_ = 0.0;
+    time_last_progress_ = 0.0;
+    num_scheduled_ = 0;
+    num_processed_ = 0;
+}
+
+/* 事象クラス */
+
+/*!
+ * @brief 発生時刻, 投入順で比較する
+ * @param other 比較対象
+ * @retval true 自身が後に発生する
+ * @retval false 自身が先に発生する
+ */
+bool EventScheduler::Event::operator>(const Event &other) const {
+    if (time_ != other.time_) {
+        return time_ > other.time_;
+    }
+
+    return seq_ > other.seq_;
+}
@@ -0,0 +1,77 @@
+/*!
+ * @file EventScheduler.hpp
+ * @author tom96da
+ * @brief EventScheduler クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef EVENTSCHEDULER_HPP
+#define EVENTSCHEDULER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+using namespace std;
+
+/* 離散事象シミュレーションのスケジューラクラス */
+/* 時刻付きの事象を優先度付きキューで管理し、時刻順に実行する */
+class EventScheduler {
+   private:
+    /* 事象クラス */
+    class Event;
+
+    /* 事象キュー (時刻の早い順) */
+    priority_queue<Event, vector<Event>, greater<Event>> events_;
+    /* 現在時刻[ms] */
+    double now_;
+    /* 最後に状態が進展した時刻[ms] */
+    double time_last_progress_;
+    /* 投入済み事象数 (同時刻の事象の順序付けに使う) */
+    uint64_t num_scheduled_;
+    /* 実行済み事象数 */
+    uint64_t num_processed_;
+
+    /* リンク遅延[ms] <送信元ID, 宛先ID> */
+    function<double(int, int)> link_latency_;
+    /* ノードの処理遅延[ms] */
+    const double processing_delay_;
+
+   public:
+    EventScheduler(const double link_latency = 1.0,
+                   const double processing_delay = 0.5);
+
+    double getNow() const;
+    double getTimeLastProgress() const;
+    uint64_t getNumProcessed() const;
+    bool isEmpty() const;
+
+    double getLinkLatency(const int id_sender, const int id_receiver) const;
+    double getProcessingDelay() const;
+    void setLinkLatency(function<double(int, int)> link_latency);
+
+    void schedule(const double delay, function<void()> action);
+    void markProgress();
+
+    bool step();
+    double run();
+    void reset();
+};
+
+/* 事象クラス */
+class EventScheduler::Event {
+   public:
+    /* 発生時刻[ms] */
+    double time_;
+    /* 投入順 */
+    uint64_t seq_;
+    /* 処理内容 */
+    function<void()> action_;
+
+    bool operator>(const Event &other) const;
+};
+
+#include "EventScheduler.cpp"
+
+#endif  // EVENTSCHEDULER_HPP
@@ -0,0 +1,373 @@
+/*!
+ * @file FloodingEngine.cpp
+ * @author tom96da
+ * @brief FloodingEngine クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "FloodingEngine.hpp"
+
+#include <algorithm>
+#include <bit>
+
+/* フロンティア駆動のフラッディングエンジンクラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param graph 接続グラフ
+ * @param MPRs ノードID順の MPR 集合 (各集合はID昇順)
+ *             デフォルト値: 空 (ブラインドフラッディング)
+ */
+FloodingEngine::FloodingEngine(const ConnectionGraph &graph,
+                               vector<vector<int>> MPRs)
+    : graph_{graph}, MPRs_{move(MPRs)} {}
+
+/*!
+ * @return int 開始したフラッディングの数
+ */
+int FloodingEngine::getNumFloods() const { return floods_.size(); }
+
+/*!
+ * @brief まだ送信が続くフラッディングがあるか取得
+ * @retval true ある
+ * @retval false すべて止まった
+ */
+bool FloodingEngine::isActive() const {
+    return any_of(floods_.begin(), floods_.end(), [](const Flood &flood) {
+        return !flood.frontier.empty();
+    });
+}
+
+/*!
+ * @brief ノードにデータが到達したか取得
+ * @param index フラッディングの番号 (開始順)
+ * @param id ノードID
+ * @retval true 到達した
+ * @retval false 到達していない
+ */
+bool FloodingEngine::hasData(const int index, const int id) const {
+    return floods_[index].has_data[id / 64] >> (id % 64) & 1;
+}
+
+/*!
+ * @param index フラッディングの番号 (開始順)
+ * @return const Result& フラッディング結果
+ */
+const FloodingEngine::Result &FloodingEngine::getResult(
+    const int index) const {
+    return floods_[index].result;
+}
+
+/*!
+ * @brief フラッディングを開始する
+ * @details 開始ノードが最初のホップで送信するまでは何も送らない
+ * @param id_source 開始ノードのID
+ * @return int フラッディングの番号 (開始順)
+ */
+int FloodingEngine::start(const int id_source) {
+    /* ビット集合のワード数 */
+    const int num_words = (graph_.getNumNodes() + 63) / 64;
+    /* 開始ノードのビット */
+    const uint64_t bit = uint64_t{1} << (id_source % 64);
+
+    auto &flood = floods_.emplace_back();
+    flood.has_data.assign(num_words, 0);
+    flood.has_data[id_source / 64] |= bit;
+    if (isMPRFlooding()) {
+        /* 開始ノードは必ず再送する */
+        flood.is_relaying.assign(num_words, 0);
+        flood.is_relaying[id_source / 64] |= bit;
+    }
+    /* 開始ノードは送信元を持たないので、すべての接続に送信する */
+    flood.frontier.emplace_back(id_source, id_source);
+    flood.result = {id_source, 0, 0, 1, 0, {1}};
+
+    return getNumFloods() - 1;
+}
+
+/*!
+ * @brief 送信が続くすべてのフラッディングを1ホップ進める
+ * @param pool フラッディングごとの処理を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ * @retval true まだ送信が続くフラッディングがある
+ * @retval false すべて止まった
+ */
+bool FloodingEngine::step(ThreadPool *pool) {
+    auto task = [&](const int index) { stepFlood(floods_[index]); };
+
+    if (pool == nullptr) {
+        for (int index = 0; index < getNumFloods(); index++) {
+            task(index);
+        }
+    } else {
+        pool->parallelFor(getNumFloods(), task);
+    }
+
+    return isActive();
+}
+
+/*!
+ * @brief すべてのフラッディングを送信が止まるまで進める
+ * @param pool フラッディングごとの処理を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ */
+void FloodingEngine::run(ThreadPool *pool) {
+    while (step(pool)) {
+    }
+}
+
+/*!
+ * @retval true MPR フラッディング
+ * @retval false ブラインドフラッディング
+ */
+bool FloodingEngine::isMPRFlooding() const { return !MPRs_.empty(); }
+
+/*!
+ * @brief ノードが相手の MPR 集合に含まれるか取得
+ * @param id_selector 相手ノードのID
+ * @param id ノードID
+ * @retval true MPR に選ばれている
+ * @retval false 選ばれていない
+ */
+bool FloodingEngine::isSelectedAsMPR(const int id_selector,
+                                     const int id) const {
+    const auto &MPRs = MPRs_[id_selector];
+    return binary_search(MPRs.begin(), MPRs.end(), id);
+}
+
+/*!
+ * @brief 1つのフラッディングを1ホップ進める
+ * @details DeviceManager::flooding と同じく、フロンティアのノードはID順に
+ *          送信元以外の接続に送信する。MPR フラッディングでは、まだ再送して
+ *          いないノードが、自身を MPR に選んだ送信元から最初に受信したときに
+ *          その送信元を除いて次のホップで再送する (RFC 3626 3.4)。
+ * @param flood フラッディングの状態
+ */
+void FloodingEngine::stepFlood(Flood &flood) const {
+    if (flood.frontier.empty()) {
+        return;
+    }
+
+    auto &result = flood.result;
+    auto &frontier = flood.frontier;
+    /* 次のホップで再送するノード */
+    vector<pair<int, int>> frontier_next;
+    /* このホップで新たに到達したノード数 */
+    int num_reach_new = 0;
+    /* このホップの開始時の送信パケット数 */
+    const int num_transmissions_start = result.num_transmissions;
+
+    /* ビットを立て、立っていなかったか返す */
+    auto setBit = [](vector<uint64_t> &bits, const int id) {
+        const uint64_t bit = uint64_t{1} << (id % 64);
+        const bool is_new = !(bits[id / 64] & bit);
+        bits[id / 64] |= bit;
+        return is_new;
+    };
+
+    sort(frontier.begin(), frontier.end());
+    for (const auto &[id, id_sender] : frontier) {
+        for (const auto id_next : graph_.getNeighbors(id)) {
+            if (id_next == id_sender) {
+                continue;
+            }
+
+            result.num_transmissions++;
+            if (setBit(flood.has_data, id_next)) {
+                num_reach_new++;
+                if (!isMPRFlooding()) {
+                    /* 初めて受信したノードが再送する */
+                    frontier_next.emplace_back(id_next, id);
+                    continue;
+                }
+            } else {
+                result.num_duplicates++;
+            }
+
+            if (isMPRFlooding() && isSelectedAsMPR(id, id_next) &&
+                setBit(flood.is_relaying, id_next)) {
+                /* 自身を MPR に選んだ送信元から受信すれば再送する */
+                frontier_next.emplace_back(id_next, id);
+            }
+        }
+    }
+    frontier = move(frontier_next);
+
+    if (result.num_transmissions == num_transmissions_start) {
+        /* 送信がなければ止まった */
+        return;
+    }
+    result.num_reach += num_reach_new;
+    result.num_step++;
+    result.reach_per_hop.push_back(num_reach_new);
+}
+
+/*!
+ * @brief すべてのノードを始点とするフラッディングを一括で行う
+ * @details 始点をビットに割り当て、最大 NUM_LANES 個の始点のフラッディングを
+ *          ノードごとのビット集合の OR で同時に進める。結果は始点ごとに
+ *          start と run で1つずつ進めたものと一致する。
+ * @param pool 始点のまとまりごとの処理を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ * @return vector<Result> 始点のノードID順のフラッディング結果
+ */
+vector<FloodingEngine::Result> FloodingEngine::floodAll(
+    ThreadPool *pool) const {
+    vector<Result> results(graph_.getNumNodes());
+    /* グラフ上で近い始点を同じまとまりにし、波面をそろえる */
+    const auto order = graph_.makeTraversalOrder();
+    /* 始点のまとまりの数 */
+    const int num_batches = (graph_.getNumNodes() + NUM_LANES - 1) / NUM_LANES;
+
+    /* まとまりごとに書き込む結果が異なるので並列に進められる */
+    auto task = [&](const int batch) {
+        const auto first = order.begin() + batch * NUM_LANES;
+        const auto last = order.begin() + min<int>((batch + 1) * NUM_LANES,
+                                                   order.size());
+        floodBatch(vector<int>(first, last), results);
+    };
+
+    if (pool == nullptr) {
+        for (int batch = 0; batch < num_batches; batch++) {
+            task(batch);
+        }
+    } else {
+        pool->parallelFor(num_batches, task);
+    }
+
+    return results;
+}
+
+/*!
+ * @brief 最大 NUM_LANES 個の始点からのフラッディングを同時に進める
+ * @details 送信元への送信は、送信元がすでにデータを持ち再送も済ませているので
+ *          到達にも再送にも影響しない。そこで各ノードは接続中のすべてのノードに
+ *          ビット集合を伝え、送信パケット数だけ送信元の分を除いて数える。
+ * @param sources 始点のノードID (添字がビットに対応)
+ * @param results 始点のノードID順のフラッディング結果 (このまとまりの
+ *                始点の分を書き込む)
+ */
+void FloodingEngine::floodBatch(const vector<int> &sources,
+                                vector<Result> &results) const {
+    const int num_nodes = graph_.getNumNodes();
+    const int num_sources = sources.size();
+    /* ビット集合が空か */
+    auto isEmpty = [](const Lanes &lanes) {
+        uint64_t any = 0;
+        for (const auto word : lanes) {
+            any |= word;
+        }
+        return any == 0;
+    };
+
+    /* データを持つ始点 */
+    vector<Lanes> has_data(num_nodes, Lanes{});
+    /* 再送が決まった始点 (MPR フラッディングのみ) */
+    vector<Lanes> is_relaying(isMPRFlooding() ? num_nodes : 0, Lanes{});
+    /* このホップで再送する始点 */
+    vector<Lanes> relay(num_nodes, Lanes{});
+    /* このホップで受信する始点 */
+    vector<Lanes> receive(num_nodes, Lanes{});
+    /* このホップで自身を MPR に選んだ送信元から受信する始点 */
+    vector<Lanes> receive_from_selector(isMPRFlooding() ? num_nodes : 0,
+                                        Lanes{});
+    /* このホップで再送するノード */
+    vector<int> frontier;
+    /* このホップで受信するノード */
+    vector<int> receivers;
+    /* 始点ごとのこのホップの送信パケット数と新たに到達したノード数 */
+    vector<int> num_transmissions(num_sources), num_reach_new(num_sources);
+
+    for (int lane = 0; lane < num_sources; lane++) {
+        const int id_source = sources[lane];
+        const uint64_t bit = uint64_t{1} << (lane % 64);
+        has_data[id_source][lane / 64] |= bit;
+        relay[id_source][lane / 64] |= bit;
+        if (isMPRFlooding()) {
+            is_relaying[id_source][lane / 64] |= bit;
+        }
+        frontier.push_back(id_source);
+        results[id_source] = {id_source, 0, 0, 1, 0, {1}};
+    }
+
+    while (!frontier.empty()) {
+        fill(num_transmissions.begin(), num_transmissions.end(), 0);
+        fill(num_reach_new.begin(), num_reach_new.end(), 0);
+
+        /* 再送する始点を接続中のノードへ伝える */
+        receivers.clear();
+        for (const auto id : frontier) {
+            const auto &lanes = relay[id];
+            const int degree = graph_.getDegree(id);
+            for (int word = 0; word < NUM_LANE_WORDS; word++) {
+                for (uint64_t bits = lanes[word]; bits; bits &= bits - 1) {
+                    /* 始点以外は送信元に送らない */
+                    const int lane = word * 64 + countr_zero(bits);
+                    num_transmissions[lane] +=
+                        sources[lane] == id ? degree : degree - 1;
+                }
+            }
+
+            for (const auto id_next : graph_.getNeighbors(id)) {
+                auto &lanes_next = receive[id_next];
+                if (isEmpty(lanes_next)) {
+                    receivers.push_back(id_next);
+                }
+                for (int word = 0; word < NUM_LANE_WORDS; word++) {
+                    lanes_next[word] |= lanes[word];
+                }
+                if (isMPRFlooding() && isSelectedAsMPR(id, id_next)) {
+                    for (int word = 0; word < NUM_LANE_WORDS; word++) {
+                        receive_from_selector[id_next][word] |= lanes[word];
+                    }
+                }
+            }
+            relay[id] = Lanes{};
+        }
+
+        /* 受信したノードから次のホップで再送するノードを決める */
+        frontier.clear();
+        for (const auto id : receivers) {
+            for (int word = 0; word < NUM_LANE_WORDS; word++) {
+                /* 初めて受信した始点 */
+                const uint64_t fresh = receive[id][word] & ~has_data[id][word];
+                has_data[id][word] |= fresh;
+                for (uint64_t bits = fresh; bits; bits &= bits - 1) {
+                    num_reach_new[word * 64 + countr_zero(bits)]++;
+                }
+
+                if (isMPRFlooding()) {
+                    /* まだ再送していない始点を MPR セレクタから受信すれば
+                       再送する */
+                    relay[id][word] = receive_from_selector[id][word] &
+                                      ~is_relaying[id][word];
+                    is_relaying[id][word] |= relay[id][word];
+                } else {
+                    relay[id][word] = fresh;
+                }
+            }
+            receive[id] = Lanes{};
+            if (isMPRFlooding()) {
+                receive_from_selector[id] = Lanes{};
+            }
+
+            if (!isEmpty(relay[id])) {
+                frontier.push_back(id);
+            }
+        }
+
+        for (int lane = 0; lane < num_sources; lane++) {
+            if (num_transmissions[lane] == 0) {
+                /* 送信がなければその始点のフラッディングは止まった */
+                continue;
+            }
+            auto &result = results[sources[lane]];
+            result.num_transmissions += num_transmissions[lane];
+            result.num_duplicates +=
+                num_transmissions[lane] - num_reach_new[lane];
+            result.num_reach += num_reach_new[lane];
+            result.num_step++;
+            result.reach_per_hop.push_back(num_reach_new[lane]);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*!
+ * @file FloodingEngine.hpp
+ * @author tom96da
+ * @brief FloodingEngine クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef FLOODINGENGINE_HPP
+#define FLOODINGENGINE_HPP
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ConnectionGraph.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+/* フロンティア駆動のフラッディングエンジンクラス */
+/* 各ホップでは直前に受信して再送するノード (フロンティア) の接続だけを調べ、
+   1ホップの処理量をフロンティアの辺数に抑える。フラッディングごとに状態を
+   持つので、複数の始点のフラッディングを同時に進められる。 */
+class FloodingEngine {
+   public:
+    /* フラッディング結果構造体 */
+    struct Result {
+        int id_source;             /* 開始ノードのID */
+        int num_transmissions;     /* 送信パケット数 */
+        int num_duplicates;        /* 重複受信数 */
+        int num_reach;             /* 到達ノード数 (開始ノードを含む) */
+        int num_step;              /* 送信が止まるまでのホップ数 */
+        vector<int> reach_per_hop; /* ホップごとに新たに到達したノード数 */
+    };
+
+   private:
+    /* 一括フラッディングで同時に進める始点数 / 64 */
+    static constexpr int NUM_LANE_WORDS = 4;
+    /* 一括フラッディングで同時に進める始点数 */
+    static constexpr int NUM_LANES = NUM_LANE_WORDS * 64;
+    /* 始点ごとのビット集合 */
+    using Lanes = array<uint64_t, NUM_LANE_WORDS>;
+
+    /* 1つのフラッディングの状態 */
+    struct Flood {
+        /* データを持つノードのビット集合 */
+        vector<uint64_t> has_data;
+        /* 再送が決まったノードのビット集合 (MPR フラッディングのみ) */
+        vector<uint64_t> is_relaying;
+        /* 次のホップで再送するノード <ノードID, 送信元ID> */
+        vector<pair<int, int>> frontier;
+        /* 結果 */
+        Result result;
+    };
+
+    /* 接続グラフ */
+    const ConnectionGraph &graph_;
+    /* ノードごとの MPR 集合 (ID昇順, 空なら全ノードが再送する) */
+    vector<vector<int>> MPRs_;
+    /* フラッディングの状態 (開始順) */
+    vector<Flood> floods_;
+
+   public:
+    FloodingEngine(const ConnectionGraph &graph,
+                   vector<vector<int>> MPRs = {});
+
+    int getNumFloods() const;
+    bool isActive() const;
+    bool hasData(const int index, const int id) const;
+    const Result &getResult(const int index) const;
+
+    int start(const int id_source);
+    bool step(ThreadPool *pool = nullptr);
+    void run(ThreadPool *pool = nullptr);
+
+    vector<Result> floodAll(ThreadPool *pool = nullptr) const;
+
+   private:
+    bool isMPRFlooding() const;
+    bool isSelectedAsMPR(const int id_selector, const int id) const;
+    void stepFlood(Flood &flood) const;
+    void floodBatch(const vector<int> &sources,
+                    vector<Result> &results) const;
+};
+
+#include "FloodingEngine.cpp"
+
+#endif  // FLOODINGENGINE_HPP
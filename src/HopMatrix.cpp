@@ -0,0 +1,318 @@
+/*!
+ * @file HopMatrix.cpp
+ * @author tom96da
+ * @brief HopMatrix クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "HopMatrix.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+/* 全点対ホップ数行列クラス */
+
+/* コンストラクタ (空の行列) */
+HopMatrix::HopMatrix() : num_nodes_{0} {}
+
+/*!
+ * @brief コンストラクタ 接続グラフから全点対のホップ数を求める
+ * @details 254 ホップを超える距離は表せないため、到達できないものとして扱う
+ * @param graph 接続グラフ
+ * @param pool 始点のまとまりごとの探索を並列実行するスレッドプール
+ *             (nullptr なら逐次)
+ */
+HopMatrix::HopMatrix(const ConnectionGraph &graph, ThreadPool *pool)
+    : num_nodes_{graph.getNumNodes()},
+      rank_(num_nodes_),
+      hops_(static_cast<size_t>(num_nodes_) * num_nodes_, UNREACHABLE) {
+    /* 始点のまとまりの数 */
+    const int num_batches = (num_nodes_ + NUM_LANES - 1) / NUM_LANES;
+    /* 近くの始点を同じまとまりにするための探索順 */
+    const auto order = makeSearchOrder(graph);
+    for (int rank = 0; rank < num_nodes_; rank++) {
+        /* 行列もこの順に並べ、まとまりの書き込み先を連続させる */
+        rank_[order[rank]] = rank;
+    }
+
+    /* 並び順で番号を付け直した隣接リスト (rank の隣接は
+       neighbors[offsets[rank]] から neighbors[offsets[rank + 1]] の手前まで) */
+    vector<int> offsets{0}, neighbors;
+    offsets.reserve(num_nodes_ + 1);
+    for (const auto id : order) {
+        for (const auto id_next : graph.getNeighbors(id)) {
+            neighbors.push_back(rank_[id_next]);
+        }
+        offsets.push_back(neighbors.size());
+    }
+
+    /* まとまりごとに書き込む列が異なるので並列に探索できる */
+    auto task = [&](const int batch) {
+        searchBatch(offsets, neighbors, batch * NUM_LANES);
+    };
+
+    if (pool == nullptr) {
+        for (int batch = 0; batch < num_batches; batch++) {
+            task(batch);
+        }
+    } else {
+        pool->parallelFor(num_batches, task);
+    }
+}
+
+/*!
+ * @return int ノード数
+ */
+int HopMatrix::getNumNodes() const { return num_nodes_; }
+
+/*!
+ * @param id_source 始点ノードのID
+ * @param id_dest 終点ノードのID
+ * @return int ホップ数 (到達できなければ -1)
+ */
+int HopMatrix::getNumHop(const int id_source, const int id_dest) const {
+    const auto hop = hops_[static_cast<size_t>(rank_[id_source]) * num_nodes_ +
+                           rank_[id_dest]];
+
+    return hop == UNREACHABLE ? -1 : hop;
+}
+
+/*!
+ * @param id_source 始点ノードのID
+ * @return span<const uint8_t> 始点から各ノードへのホップ数 (行列上の並び順)
+ */
+span<const uint8_t> HopMatrix::getRow(const int id_source) const {
+    return {hops_.data() + static_cast<size_t>(rank_[id_source]) * num_nodes_,
+            static_cast<size_t>(num_nodes_)};
+}
+
+/*!
+ * @brief 始点から到達できるノードのホップ数の度数分布を集計する
+ * @details 収束後のルーティングテーブルの度数分布と一致する
+ * @param id_source 始点ノードのID
+ * @return map<int, int> ホップ数ごとのノード数
+ */
+map<int, int> HopMatrix::calculateFrequency(const int id_source) const {
+    /* ホップ数ごとのノード数 */
+    array<int, UNREACHABLE + 1> count{};
+    for (const auto hop : getRow(id_source)) {
+        ++count[hop];
+    }
+
+    /* 度数分布 (自身と到達できないノードは除く) */
+    map<int, int> frequency;
+    for (int hop = 1; hop < UNREACHABLE; hop++) {
+        if (count[hop] > 0) {
+            frequency.emplace(hop, count[hop]);
+        }
+    }
+
+    return frequency;
+}
+
+/*!
+ * @brief ホップ数で最も中心にあるノードを取得する
+ * @details 到達できるノードが最も多く、その中で総ホップ数が最小のノード
+ *          (近接中心性が最大のノード) を選ぶ。同点なら ID が小さい方。
+ * @return int 中心ノードのID (ノードがなければ -1)
+ */
+int HopMatrix::getCentralNode() const {
+    int id_central = -1;
+    /* 中心ノードの到達ノード数と総ホップ数 */
+    int num_reach_best = -1;
+    int64_t sum_hop_best = numeric_limits<int64_t>::max();
+
+    for (int id = 0; id < num_nodes_; id++) {
+        int num_reach = 0;
+        int64_t sum_hop = 0;
+        for (const auto hop : getRow(id)) {
+            if (hop != UNREACHABLE) {
+                ++num_reach;
+                sum_hop += hop;
+            }
+        }
+
+        if (num_reach > num_reach_best ||
+            (num_reach == num_reach_best && sum_hop < sum_hop_best)) {
+            id_central = id;
+            num_reach_best = num_reach;
+            sum_hop_best = sum_hop;
+        }
+    }
+
+    return id_central;
+}
+
+/*!
+ * @brief 到達できる全ノード対の最短経路の平均ホップ数を取得する
+ * @return double 平均ホップ数 (ノード対がなければ 0)
+ */
+double HopMatrix::getAverageHop() const {
+    int64_t num_pairs = 0, sum_hop = 0;
+    for (const auto hop : hops_) {
+        if (hop != 0 && hop != UNREACHABLE) {
+            ++num_pairs;
+            sum_hop += hop;
+        }
+    }
+
+    return num_pairs > 0 ? static_cast<double>(sum_hop) / num_pairs : 0.0;
+}
+
+/*!
+ * @brief 到達できるノード対の最大ホップ数 (直径) を取得する
+ * @return int 直径
+ */
+int HopMatrix::getDiameter() const {
+    int diameter = 0;
+    for (const auto hop : hops_) {
+        if (hop != UNREACHABLE) {
+            diameter = max(diameter, static_cast<int>(hop));
+        }
+    }
+
+    return diameter;
+}
+
+/*!
+ * @brief グラフ上で近いノードが連続するように並べる
+ * @details 未割当のノードだけをたどる幅優先探索で NUM_LANES 個ずつの塊を
+ *          作り、塊が埋まれば直前の探索の縁から次の塊を育てる。近い始点を
+ *          同じまとまりで探索すると波面がそろい、各ノードが探索に関わる
+ *          ホップ数が少なくなる。
+ * @param graph 接続グラフ
+ * @return vector<int> 並べたノードID
+ */
+vector<int> HopMatrix::makeSearchOrder(const ConnectionGraph &graph) const {
+    vector<int> order;
+    order.reserve(num_nodes_);
+    vector<bool> is_assigned(num_nodes_, false);
+    /* 探索キュー */
+    vector<int> queue;
+
+    auto assign = [&](const int id) {
+        is_assigned[id] = true;
+        order.push_back(id);
+        queue.push_back(id);
+    };
+
+    for (int id_root = 0; id_root < num_nodes_; id_root++) {
+        if (is_assigned[id_root]) {
+            continue;
+        }
+        /* 未割当のノードから塊を育てる */
+        queue.clear();
+        assign(id_root);
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (const auto id_next : graph.getNeighbors(queue[head])) {
+                if (is_assigned[id_next]) {
+                    continue;
+                }
+                if (order.size() % NUM_LANES == 0) {
+                    /* 塊が埋まれば、縁のノードから次の塊を育て直す */
+                    queue = {queue[head]};
+                    head = 0;
+                }
+                assign(id_next);
+            }
+        }
+    }
+
+    return order;
+}
+
+/*!
+ * @brief 並び順で連続する最大 NUM_LANES 個の始点から同時に幅優先探索する
+ * @details ノードごとに「どの始点の探索が到達済みか」をビット集合で持ち、
+ *          1ホップ進めるたびに新たに到達したノードから隣接ノードへ OR で
+ *          伝える。ノードはすべて並び順で扱う。
+ * @param offsets 各ノードの隣接リストの開始位置
+ * @param neighbors 隣接ノード
+ * @param rank_first 先頭の始点の並び順
+ */
+void HopMatrix::searchBatch(const vector<int> &offsets,
+                            const vector<int> &neighbors,
+                            const int rank_first) {
+    /* このまとまりの始点数 */
+    const int num_sources = min(NUM_LANES, num_nodes_ - rank_first);
+    /* ビット集合が空か */
+    auto isEmpty = [](const Lanes &lanes) {
+        uint64_t any = 0;
+        for (const auto word : lanes) {
+            any |= word;
+        }
+        return any == 0;
+    };
+
+    /* 到達済みの始点 */
+    vector<Lanes> seen(num_nodes_, Lanes{});
+    /* 直前のホップで新たに到達した始点 */
+    vector<Lanes> visit(num_nodes_, Lanes{});
+    /* 次のホップで到達する始点 */
+    vector<Lanes> visit_next(num_nodes_, Lanes{});
+    /* 直前のホップで新たに到達したノード */
+    vector<int> frontier;
+    /* 次のホップで到達する候補のノード */
+    vector<int> candidates;
+    /* このまとまりの列 (ノードごとに NUM_LANES 個連続させ、最後に写す) */
+    vector<uint8_t> columns(static_cast<size_t>(num_nodes_) * NUM_LANES,
+                            UNREACHABLE);
+
+    for (int lane = 0; lane < num_sources; lane++) {
+        /* 始点は自身に 0 ホップで到達している */
+        const int source = rank_first + lane;
+        seen[source][lane / 64] |= uint64_t{1} << (lane % 64);
+        visit[source][lane / 64] |= uint64_t{1} << (lane % 64);
+        columns[static_cast<size_t>(source) * NUM_LANES + lane] = 0;
+        frontier.push_back(source);
+    }
+
+    for (int hop = 1; hop < UNREACHABLE && !frontier.empty(); hop++) {
+        /* 新たに到達した始点を隣接ノードへ伝える */
+        candidates.clear();
+        for (const auto node : frontier) {
+            const auto &lanes = visit[node];
+            for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+                auto &lanes_next = visit_next[neighbors[i]];
+                if (isEmpty(lanes_next)) {
+                    candidates.push_back(neighbors[i]);
+                }
+                for (int word = 0; word < NUM_LANE_WORDS; word++) {
+                    lanes_next[word] |= lanes[word];
+                }
+            }
+        }
+
+        /* 未到達だった始点だけを残し、ホップ数を記録する */
+        frontier.clear();
+        for (const auto node : candidates) {
+            /* 無向グラフなので、始点からのホップ数を到達したノードの行に書く */
+            auto *row = columns.data() + static_cast<size_t>(node) * NUM_LANES;
+            for (int word = 0; word < NUM_LANE_WORDS; word++) {
+                const uint64_t fresh =
+                    visit_next[node][word] & ~seen[node][word];
+                seen[node][word] |= fresh;
+                visit[node][word] = fresh;
+
+                for (uint64_t bits = fresh; bits; bits &= bits - 1) {
+                    /* 立っているビットを下位から順に取り出す */
+                    row[word * 64 + countr_zero(bits)] = hop;
+                }
+            }
+            visit_next[node] = Lanes{};
+
+            if (!isEmpty(visit[node])) {
+                frontier.push_back(node);
+            }
+        }
+    }
+
+    for (int node = 0; node < num_nodes_; node++) {
+        /* 各ノードの行のこのまとまりの列に写す */
+        copy_n(columns.begin() + static_cast<size_t>(node) * NUM_LANES,
+               num_sources,
+               hops_.begin() + static_cast<size_t>(node) * num_nodes_ +
+                   rank_first);
+    }
+}
@@ -0,0 +1,66 @@
+/*!
+ * @file HopMatrix.hpp
+ * @author tom96da
+ * @brief HopMatrix クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef HOPMATRIX_HPP
+#define HOPMATRIX_HPP
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+
+#include "ConnectionGraph.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+/* 全点対ホップ数行列クラス */
+/* 複数始点の幅優先探索 (MS-BFS) を、始点をビットに割り当てて同時に進める */
+class HopMatrix {
+   public:
+    /* 到達できないことを表すホップ数 */
+    static constexpr uint8_t UNREACHABLE = 255;
+
+   private:
+    /* 1回の探索で同時に進める始点数 / 64 */
+    static constexpr int NUM_LANE_WORDS = 4;
+    /* 1回の探索で同時に進める始点数 */
+    static constexpr int NUM_LANES = NUM_LANE_WORDS * 64;
+    /* 始点ごとのビット集合 */
+    using Lanes = array<uint64_t, NUM_LANE_WORDS>;
+
+    /* ノード数 */
+    int num_nodes_;
+    /* ノードIDから行列上の並び順への対応 */
+    vector<int> rank_;
+    /* ホップ数 (並び順で 始点 * ノード数 + 終点 を添字とする) */
+    vector<uint8_t> hops_;
+
+   public:
+    HopMatrix();
+    HopMatrix(const ConnectionGraph &graph, ThreadPool *pool = nullptr);
+
+    int getNumNodes() const;
+    int getNumHop(const int id_source, const int id_dest) const;
+
+    map<int, int> calculateFrequency(const int id_source) const;
+    int getCentralNode() const;
+    double getAverageHop() const;
+    int getDiameter() const;
+
+   private:
+    span<const uint8_t> getRow(const int id_source) const;
+
+    vector<int> makeSearchOrder(const ConnectionGraph &graph) const;
+    void searchBatch(const vector<int> &offsets, const vector<int> &neighbors,
+                     const int rank_first);
+};
+
+#include "HopMatrix.cpp"
+
+#endif  // HOPMATRIX_HPP
@@ -0,0 +1,311 @@
+/*!
+ * @file MPRSelector.cpp
+ * @author tom96da
+ * @brief MPRSelector クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "MPRSelector.hpp"
+
+#include <algorithm>
+#include <bit>
+
+/* ビット集合による MPR 選択クラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param graph 接続グラフ
+ */
+MPRSelector::MPRSelector(const ConnectionGraph &graph) : graph_{graph} {}
+
+/*!
+ * @brief 1つのノードの MPR 集合を選ぶ
+ * @tparam PriorityOf double(int, int) として呼べる型
+ * @param id ノードID
+ * @param heuristic 選択方式
+ * @param priority_of (ノード, 隣接ノード) から隣接ノードの優先度を得る処理
+ *                    (大きいほど優先)
+ * @return vector<int> MPR のID (昇順)
+ */
+template <class PriorityOf>
+vector<int> MPRSelector::select(const int id, const Heuristic heuristic,
+                                const PriorityOf &priority_of) const {
+    /* スレッドごとに使い回す作業領域 */
+    thread_local Workspace workspace;
+    const int num_words = prepare(id, priority_of, workspace);
+
+    switch (heuristic) {
+        case Heuristic::IN_ORDER:
+            selectInOrder(num_words, workspace);
+            break;
+        case Heuristic::RFC3626:
+            selectGreedy(num_words, workspace);
+            break;
+        default:
+            break;
+    }
+
+    vector<int> MPRs;
+    for (int i = 0; i < static_cast<int>(workspace.neighbors.size()); i++) {
+        if (workspace.is_selected[i]) {
+            MPRs.push_back(workspace.neighbors[i].id);
+        }
+    }
+    sort(MPRs.begin(), MPRs.end());
+
+    return MPRs;
+}
+
+/*!
+ * @brief すべてのノードの MPR 集合を選ぶ
+ * @tparam PriorityOf double(int, int) として呼べる型
+ * @param heuristic 選択方式
+ * @param priority_of (ノード, 隣接ノード) から隣接ノードの優先度を得る処理
+ * @param pool ノードごとの選択を並列実行するスレッドプール (nullptr なら逐次)
+ * @return vector<vector<int>> ノードID順の MPR 集合
+ */
+template <class PriorityOf>
+vector<vector<int>> MPRSelector::selectAll(const Heuristic heuristic,
+                                           const PriorityOf &priority_of,
+                                           ThreadPool *pool) const {
+    vector<vector<int>> MPRs(graph_.getNumNodes());
+    /* グラフ上で近いノードを続けて処理し、隣接リストをキャッシュに載せる */
+    const auto order = graph_.makeTraversalOrder();
+    auto task = [&](const int index) {
+        MPRs[order[index]] = select(order[index], heuristic, priority_of);
+    };
+
+    if (pool == nullptr) {
+        for (int index = 0; index < graph_.getNumNodes(); index++) {
+            task(index);
+        }
+    } else {
+        pool->parallelFor(graph_.getNumNodes(), task);
+    }
+
+    return MPRs;
+}
+
+/*!
+ * @brief MPR 集合で覆われない2ホップ隣接の数を数える
+ * @param id ノードID
+ * @param MPRs MPR のID
+ * @return int 覆われない2ホップ隣接の数 (0 なら正しい MPR 集合)
+ */
+int MPRSelector::countUncovered(const int id, span<const int> MPRs) const {
+    thread_local Workspace workspace;
+    /* 覆う範囲だけを見るので、隣接ノードの順序は問わない */
+    const int num_words =
+        prepare(id, [](const int, const int) { return 0.0; }, workspace);
+
+    for (int i = 0; i < static_cast<int>(workspace.neighbors.size()); i++) {
+        if (find(MPRs.begin(), MPRs.end(), workspace.neighbors[i].id) ==
+            MPRs.end()) {
+            continue;
+        }
+        for (int word = 0; word < num_words; word++) {
+            /* MPR が覆う2ホップ隣接を除く */
+            workspace.uncovered[word] &=
+                ~workspace.coverage[i * num_words + word];
+        }
+    }
+
+    int num_uncovered = 0;
+    for (const auto word : workspace.uncovered) {
+        num_uncovered += popcount(word);
+    }
+
+    return num_uncovered;
+}
+
+/*!
+ * @brief 隣接ノードを優先順に並べ、2ホップ隣接のビット集合を作る
+ * @details 隣接ノードは、従来の makeMPR が hello を処理する順 (ID降順) から
+ *          優先度の降順に並べ替える。同じ優先度の順序も従来と一致する。
+ * @tparam PriorityOf double(int, int) として呼べる型
+ * @param id ノードID
+ * @param priority_of (ノード, 隣接ノード) から隣接ノードの優先度を得る処理
+ * @param workspace 作業領域
+ * @return int ビット集合のワード数
+ */
+template <class PriorityOf>
+int MPRSelector::prepare(const int id, const PriorityOf &priority_of,
+                         Workspace &workspace) const {
+    auto &neighbors = workspace.neighbors;
+    auto &two_hop_neighbors = workspace.two_hop_neighbors;
+    const auto id_neighbors = graph_.getNeighbors(id);
+
+    neighbors.clear();
+    for (auto it = id_neighbors.rbegin(); it != id_neighbors.rend(); ++it) {
+        neighbors.push_back({*it, priority_of(id, *it)});
+    }
+    sort(neighbors.begin(), neighbors.end(),
+         [](const Neighbor &left, const Neighbor &right) {
+             return left.priority > right.priority;
+         });
+
+    two_hop_neighbors.clear();
+    for (const auto id_neighbor : id_neighbors) {
+        for (const auto id_two_hop : graph_.getNeighbors(id_neighbor)) {
+            /* 自身と隣接ノードは除く */
+            if (id_two_hop != id && !graph_.isAdjacent(id, id_two_hop)) {
+                two_hop_neighbors.push_back(id_two_hop);
+            }
+        }
+    }
+    sort(two_hop_neighbors.begin(), two_hop_neighbors.end());
+    two_hop_neighbors.erase(
+        unique(two_hop_neighbors.begin(), two_hop_neighbors.end()),
+        two_hop_neighbors.end());
+
+    /* ワード数 */
+    const int num_bits = two_hop_neighbors.size();
+    const int num_words = (num_bits + 63) / 64;
+
+    workspace.coverage.assign(neighbors.size() * num_words, 0);
+    for (int i = 0; i < static_cast<int>(neighbors.size()); i++) {
+        for (const auto id_two_hop : graph_.getNeighbors(neighbors[i].id)) {
+            auto it = lower_bound(two_hop_neighbors.begin(),
+                                  two_hop_neighbors.end(), id_two_hop);
+            if (it == two_hop_neighbors.end() || *it != id_two_hop) {
+                continue;
+            }
+            /* 覆う2ホップ隣接のビットを立てる */
+            const int bit = it - two_hop_neighbors.begin();
+            workspace.coverage[i * num_words + bit / 64] |= uint64_t{1}
+                                                            << (bit % 64);
+        }
+    }
+
+    workspace.uncovered.assign(num_words, ~uint64_t{0});
+    if (num_bits % 64 != 0) {
+        /* 末尾のワードは使うビットだけ立てる */
+        workspace.uncovered.back() = (uint64_t{1} << (num_bits % 64)) - 1;
+    }
+    workspace.is_selected.assign(neighbors.size(), false);
+
+    return num_words;
+}
+
+/*!
+ * @brief 優先順に、まだ覆われていない2ホップ隣接を覆う隣接ノードを選ぶ
+ * @details 従来の makeMPR と同じ MPR 集合になる
+ * @param num_words ビット集合のワード数
+ * @param workspace 作業領域
+ */
+void MPRSelector::selectInOrder(const int num_words,
+                                Workspace &workspace) const {
+    for (int i = 0; i < static_cast<int>(workspace.neighbors.size()); i++) {
+        for (int word = 0; word < num_words; word++) {
+            const uint64_t gained = workspace.coverage[i * num_words + word] &
+                                    workspace.uncovered[word];
+            if (gained != 0) {
+                workspace.is_selected[i] = true;
+                workspace.uncovered[word] &= ~gained;
+            }
+        }
+    }
+}
+
+/*!
+ * @brief RFC 3626 8.3.1 の貪欲法で MPR を選ぶ
+ * @details 唯一の経路となる隣接ノードを先に選び、残りは覆われていない
+ *          2ホップ隣接がなくなるまで、優先度・新たに覆う数・覆う総数・
+ *          優先順の順に比べて最良の隣接ノードを選ぶ。
+ * @param num_words ビット集合のワード数
+ * @param workspace 作業領域
+ */
+void MPRSelector::selectGreedy(const int num_words,
+                               Workspace &workspace) const {
+    const int num_neighbors = workspace.neighbors.size();
+    const auto &coverage = workspace.coverage;
+    auto &uncovered = workspace.uncovered;
+    auto &is_selected = workspace.is_selected;
+
+    /* 隣接ノードを選び、覆う2ホップ隣接を除く */
+    auto choose = [&](const int i) {
+        is_selected[i] = true;
+        for (int word = 0; word < num_words; word++) {
+            uncovered[word] &= ~coverage[i * num_words + word];
+        }
+    };
+    /* 隣接ノードが覆う2ホップ隣接のうち、まだ覆われていないものの数 */
+    auto countReach = [&](const int i) {
+        int reach = 0;
+        for (int word = 0; word < num_words; word++) {
+            reach += popcount(coverage[i * num_words + word] & uncovered[word]);
+        }
+        return reach;
+    };
+    /* 隣接ノードが覆う2ホップ隣接の総数 */
+    auto countDegree = [&](const int i) {
+        int degree = 0;
+        for (int word = 0; word < num_words; word++) {
+            degree += popcount(coverage[i * num_words + word]);
+        }
+        return degree;
+    };
+
+    for (int word = 0; word < num_words; word++) {
+        /* 1つの隣接ノードからしか届かない2ホップ隣接を求める */
+        uint64_t covered_once = 0, covered_twice = 0;
+        for (int i = 0; i < num_neighbors; i++) {
+            const uint64_t bits = coverage[i * num_words + word];
+            covered_twice |= covered_once & bits;
+            covered_once |= bits;
+        }
+        const uint64_t covered_only = covered_once & ~covered_twice;
+
+        for (int i = 0; i < num_neighbors; i++) {
+            if (coverage[i * num_words + word] & covered_only) {
+                /* 唯一の経路となる隣接ノードは必ず選ぶ */
+                is_selected[i] = true;
+            }
+        }
+    }
+    for (int i = 0; i < num_neighbors; i++) {
+        if (is_selected[i]) {
+            choose(i);
+        }
+    }
+
+    while (true) {
+        /* 最良の隣接ノードとその指標 */
+        int best = -1, reach_best = 0, degree_best = 0;
+        for (int i = 0; i < num_neighbors; i++) {
+            if (is_selected[i]) {
+                continue;
+            }
+            const int reach = countReach(i);
+            if (reach == 0) {
+                continue;
+            }
+            const int degree = countDegree(i);
+            if (best < 0) {
+                best = i, reach_best = reach, degree_best = degree;
+                continue;
+            }
+
+            /* 優先度, 新たに覆う数, 覆う総数の順に比べる (同点なら優先順) */
+            const double priority = workspace.neighbors[i].priority;
+            const double priority_best = workspace.neighbors[best].priority;
+            if (priority != priority_best) {
+                if (priority > priority_best) {
+                    best = i, reach_best = reach, degree_best = degree;
+                }
+            } else if (reach != reach_best) {
+                if (reach > reach_best) {
+                    best = i, reach_best = reach, degree_best = degree;
+                }
+            } else if (degree > degree_best) {
+                best = i, reach_best = reach, degree_best = degree;
+            }
+        }
+
+        if (best < 0) {
+            /* すべての2ホップ隣接が覆われれば終了 */
+            break;
+        }
+        choose(best);
+    }
+}
@@ -0,0 +1,81 @@
+/*!
+ * @file MPRSelector.hpp
+ * @author tom96da
+ * @brief MPRSelector クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef MPRSELECTOR_HPP
+#define MPRSELECTOR_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ConnectionGraph.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+/* ビット集合による MPR 選択クラス */
+/* 2ホップ隣接をノードごとに番号付けし、各隣接ノードが覆う2ホップ隣接を
+   ビット集合で持つ。隣接ノードの優先度を得る処理はテンプレート引数で受け取り、
+   呼び出し側の方針ごとに別々にコンパイルされる */
+class MPRSelector {
+   public:
+    /* 選択方式列挙型 */
+    enum class Heuristic;
+
+   private:
+    /* 接続グラフ */
+    const ConnectionGraph &graph_;
+
+    /* 隣接ノード構造体 */
+    struct Neighbor {
+        int id;
+        double priority;
+    };
+
+    /* 1ノード分の作業領域 */
+    struct Workspace {
+        /* 隣接ノード (優先順) */
+        vector<Neighbor> neighbors;
+        /* 2ホップ隣接 (ID昇順, ビット番号に対応) */
+        vector<int> two_hop_neighbors;
+        /* 隣接ノードごとに覆う2ホップ隣接 (隣接ノード数 * ワード数) */
+        vector<uint64_t> coverage;
+        /* まだ覆われていない2ホップ隣接 */
+        vector<uint64_t> uncovered;
+        /* 選択済みの隣接ノード */
+        vector<bool> is_selected;
+    };
+
+   public:
+    MPRSelector(const ConnectionGraph &graph);
+
+    template <class PriorityOf>
+    vector<int> select(const int id, const Heuristic heuristic,
+                       const PriorityOf &priority_of) const;
+    template <class PriorityOf>
+    vector<vector<int>> selectAll(const Heuristic heuristic,
+                                  const PriorityOf &priority_of,
+                                  ThreadPool *pool = nullptr) const;
+    int countUncovered(const int id, span<const int> MPRs) const;
+
+   private:
+    template <class PriorityOf>
+    int prepare(const int id, const PriorityOf &priority_of,
+                Workspace &workspace) const;
+    void selectInOrder(const int num_words, Workspace &workspace) const;
+    void selectGreedy(const int num_words, Workspace &workspace) const;
+};
+
+/* MPR 選択方式 */
+enum class MPRSelector::Heuristic {
+    IN_ORDER, /* 優先順に、未登録の2ホップ隣接を覆う隣接ノードを選ぶ (従来) */
+    RFC3626   /* RFC 3626 8.3.1 の貪欲法 */
+};
+
+#include "MPRSelector.cpp"
+
+#endif  // MPRSELECTOR_HPP
@@ -0,0 +1,224 @@
+/*!
+ * @file NearPairList.cpp
+ * @author tom96da
+ * @brief NearPairList クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "NearPairList.hpp"
+
+/* 接続可能距離の境界をまたぐデバイス対を追跡する近傍ペアリスト */
+
+/*!
+ * @brief コンストラクタ (空のリスト)
+ */
+NearPairList::NearPairList()
+    : field_size_{1.0},
+      radius_{1.0},
+      margin_{0.0},
+      pair_offsets_{0},
+      offsets_{0} {}
+
+/*!
+ * @brief コンストラクタ
+ * @param field_size フィールドサイズ
+ * @param radius 接続可能距離
+ * @param margin 余裕幅 (大きいほど作り直しが減り、1回の更新が重くなる)
+ */
+NearPairList::NearPairList(const double field_size, const double radius,
+                           const double margin)
+    : field_size_{field_size},
+      radius_{radius},
+      margin_{margin},
+      pair_offsets_{0},
+      offsets_{0} {}
+
+/*!
+ * @return int 近傍ペア数
+ */
+int NearPairList::getNumPairs() const { return pairs_.size(); }
+
+/*!
+ * @param id デバイスID
+ * @return span<const int> 近傍のデバイスのID (順不同)
+ * @details 接続可能距離内のデバイスはすべて含まれる
+ */
+span<const int> NearPairList::getPartners(const int id) const {
+    return {partners_.data() + offsets_[id],
+            static_cast<size_t>(offsets_[id + 1] - offsets_[id])};
+}
+
+/*!
+ * @brief 現在の座標からリストを作る
+ * @details 接続可能距離内の対は距離内にあったものとして記録する
+ * @param xs x座標
+ * @param ys y座標
+ */
+void NearPairList::build(const vector<double> &xs, const vector<double> &ys) {
+    makePairs(xs, ys);
+    for (int index = 0; index < getNumPairs(); index++) {
+        is_in_range_[index] = isInRange(xs, ys, pairs_[index]);
+    }
+}
+
+/*!
+ * @brief 移動後の座標で、接続可能距離の境界をまたいだ対を求める
+ * @details 余裕幅の半分より動いたデバイスがあればリストを作り直す。
+ *          計算量は近傍ペア数に比例し、デバイス対の総数には依存しない。
+ * @param xs 移動後の x座標
+ * @param ys 移動後の y座標
+ * @param entered 距離内に入った対の格納先 (上書きされる)
+ * @param left 距離外に出た対の格納先 (上書きされる)
+ */
+void NearPairList::update(const vector<double> &xs, const vector<double> &ys,
+                          vector<pair<int, int>> &entered,
+                          vector<pair<int, int>> &left) {
+    entered.clear();
+    left.clear();
+    if (!isValid(xs, ys)) {
+        rebuild(xs, ys, left);
+    }
+
+    for (int index = 0; index < getNumPairs(); index++) {
+        /* 前回の更新時と距離内かどうかが変わった対を記録する */
+        const bool is_in_range = isInRange(xs, ys, pairs_[index]);
+        if (is_in_range == is_in_range_[index]) {
+            continue;
+        }
+        is_in_range_[index] = is_in_range;
+        (is_in_range ? entered : left).push_back(pairs_[index]);
+    }
+}
+
+/*!
+ * @brief リストを作ってから、どのデバイスも余裕幅の半分以内しか動いていないか
+ * @param xs x座標
+ * @param ys y座標
+ * @retval true リストをそのまま使える
+ * @retval false 作り直しが必要
+ */
+bool NearPairList::isValid(const vector<double> &xs,
+                           const vector<double> &ys) const {
+    if (anchor_x_.size() != xs.size()) {
+        return false;
+    }
+
+    /* 許容する移動距離の2乗 */
+    const double limit = (margin_ / 2) * (margin_ / 2);
+    for (size_t id = 0; id < xs.size(); id++) {
+        const double dx = xs[id] - anchor_x_[id];
+        const double dy = ys[id] - anchor_y_[id];
+        if (dx * dx + dy * dy > limit) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief 現在の座標でリストを作り直し、前回の更新時の状態を引き継ぐ
+ * @details 前回距離内にあった対は古いリストに必ず含まれる。新しいリストから
+ *          外れたものは余裕幅より離れているので、距離外に出た対とする。
+ * @param xs x座標
+ * @param ys y座標
+ * @param left 距離外に出た対の格納先 (追記される)
+ */
+void NearPairList::rebuild(const vector<double> &xs, const vector<double> &ys,
+                           vector<pair<int, int>> &left) {
+    /* 古いリストで距離内にあった対 */
+    vector<pair<int, int>> was_in_range;
+    for (int index = 0; index < getNumPairs(); index++) {
+        if (is_in_range_[index]) {
+            was_in_range.push_back(pairs_[index]);
+        }
+    }
+
+    makePairs(xs, ys);
+
+    for (const auto &near_pair : was_in_range) {
+        /* 新しいリストで同じ対を探して状態を引き継ぐ */
+        const int index = findPair(near_pair);
+        if (index < 0) {
+            left.push_back(near_pair);
+        } else {
+            is_in_range_[index] = true;
+        }
+    }
+}
+
+/*!
+ * @brief 接続可能距離に余裕幅を足した距離内の対を列挙する
+ * @details 距離内かどうかの状態はすべて false で初期化する
+ * @param xs x座標
+ * @param ys y座標
+ */
+void NearPairList::makePairs(const vector<double> &xs,
+                             const vector<double> &ys) {
+    const int num_devices = xs.size();
+    /* 近傍とみなす距離 */
+    const double limit = radius_ + margin_;
+
+    SpatialGrid grid(field_size_, limit);
+    grid.build(xs, ys);
+    /* 近傍 */
+    vector<int> neighbors;
+
+    offsets_.assign(1, 0);
+    offsets_.reserve(num_devices + 1);
+    pair_offsets_.assign(1, 0);
+    pair_offsets_.reserve(num_devices + 1);
+    partners_.clear();
+    pairs_.clear();
+    for (int id_1 = 0; id_1 < num_devices; id_1++) {
+        /* 近傍はセル順のまま使う (並べ替えは近傍の列挙より重い) */
+        grid.getNeighbors(xs[id_1], ys[id_1], limit, neighbors);
+        for (const auto id_2 : neighbors) {
+            if (id_1 == id_2) {
+                continue;
+            }
+            partners_.push_back(id_2);
+            if (id_1 < id_2) {
+                pairs_.emplace_back(id_1, id_2);
+            }
+        }
+        offsets_.push_back(partners_.size());
+        pair_offsets_.push_back(pairs_.size());
+    }
+
+    is_in_range_.assign(pairs_.size(), false);
+    anchor_x_ = xs;
+    anchor_y_ = ys;
+}
+
+/*!
+ * @param near_pair デバイス対 (ID1 < ID2)
+ * @return int リスト上の添字 (含まれなければ -1)
+ */
+int NearPairList::findPair(const pair<int, int> &near_pair) const {
+    const int id_1 = near_pair.first;
+    for (int index = pair_offsets_[id_1]; index < pair_offsets_[id_1 + 1];
+         index++) {
+        if (pairs_[index] == near_pair) {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+/*!
+ * @param xs x座標
+ * @param ys y座標
+ * @param near_pair デバイス対
+ * @retval true 接続可能距離内
+ * @retval false 接続可能距離外
+ */
+bool NearPairList::isInRange(const vector<double> &xs,
+                             const vector<double> &ys,
+                             const pair<int, int> &near_pair) const {
+    const auto [id_1, id_2] = near_pair;
+    const double dx = xs[id_1] - xs[id_2];
+    const double dy = ys[id_1] - ys[id_2];
+    return dx * dx + dy * dy <= radius_ * radius_;
+}
@@ -0,0 +1,70 @@
+/*!
+ * @file NearPairList.hpp
+ * @author tom96da
+ * @brief NearPairList クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef NEARPAIRLIST_HPP
+#define NEARPAIRLIST_HPP
+
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "SpatialGrid.hpp"
+
+using namespace std;
+
+/* 接続可能距離の境界をまたぐデバイス対を追跡する近傍ペアリスト */
+/* 接続可能距離に余裕幅を足した距離内の対を持っておき、どのデバイスも
+   余裕幅の半分より動いていない間は、リスト外の対が距離内に入ることはない */
+class NearPairList {
+   private:
+    /* フィールドサイズ */
+    double field_size_;
+    /* 接続可能距離 */
+    double radius_;
+    /* 余裕幅 */
+    double margin_;
+
+    /* リストを作ったときの座標 x成分 */
+    vector<double> anchor_x_;
+    /* リストを作ったときの座標 y成分 */
+    vector<double> anchor_y_;
+    /* 近傍ペア (ID1 < ID2, ID1 の昇順) */
+    vector<pair<int, int>> pairs_;
+    /* ID1 ごとの近傍ペアの先頭位置 (ID順, 末尾に総数) */
+    vector<int> pair_offsets_;
+    /* 近傍ペアが前回の更新時に接続可能距離内にあったか */
+    vector<bool> is_in_range_;
+    /* デバイスごとの近傍の先頭位置 (ID順, 末尾に総数) */
+    vector<int> offsets_;
+    /* ID順に連結した近傍のID */
+    vector<int> partners_;
+
+   public:
+    NearPairList();
+    NearPairList(const double field_size, const double radius,
+                 const double margin);
+
+    int getNumPairs() const;
+    span<const int> getPartners(const int id) const;
+
+    void build(const vector<double> &xs, const vector<double> &ys);
+    void update(const vector<double> &xs, const vector<double> &ys,
+                vector<pair<int, int>> &entered, vector<pair<int, int>> &left);
+
+   private:
+    bool isValid(const vector<double> &xs, const vector<double> &ys) const;
+    void rebuild(const vector<double> &xs, const vector<double> &ys,
+                 vector<pair<int, int>> &left);
+    void makePairs(const vector<double> &xs, const vector<double> &ys);
+    int findPair(const pair<int, int> &near_pair) const;
+    bool isInRange(const vector<double> &xs, const vector<double> &ys,
+                   const pair<int, int> &near_pair) const;
+};
+
+#include "NearPairList.cpp"
+
+#endif  // NEARPAIRLIST_HPP
@@ -0,0 +1,164 @@
+/*!
+ * @file SimulationContext.cpp
+ * @author tom96da
+ * @brief SimulationContext クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "SimulationContext.hpp"
+
+#include <iostream>
+
+/* シミュレーションコンテキストクラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param max_com_distance 接続可能距離 デフォルト値: MAX_COM_DISTANCE
+ */
+SimulationContext::SimulationContext(const double max_com_distance)
+    : num_total_packet_{0},
+      sim_mode_{SimulationMode::NONE},
+      table_update_mode_{TableUpdateMode::FULL},
+      flooding_mode_{FloodingMode::BLIND},
+      routing_mode_{RoutingMode::DISTANCE_VECTOR},
+      max_com_distance_{max_com_distance},
+      flood_step_{0},
+      scheduler_{nullptr},
+      arena_{},
+      pool_{&arena_} {}
+
+/*!
+ * @return int 累計パケット数
+ */
+int SimulationContext::getTotalPacket() const { return num_total_packet_; }
+
+/*!
+ * @return int 新規シーケンスナンバー
+ */
+int SimulationContext::getNewSequenceNum() { return num_total_packet_++; }
+
+/*!
+ * @brief 累計パケット数をリセットする
+ */
+void SimulationContext::resetNumPacket() { num_total_packet_ = 0; }
+
+/*!
+ * @brief 累計パケット数の出力
+ */
+void SimulationContext::showTotalPacket() const {
+    std::cout << "total packets: " << getTotalPacket() << std::endl;
+}
+
+/*!
+ * @return SimulationMode シミュレーションモード
+ */
+SimulationContext::SimulationMode SimulationContext::getSimMode() const {
+    return sim_mode_;
+}
+
+/*!
+ * @brief シミュレーションモードの設定
+ * @param sim_mode シミュレーションモード
+ */
+void SimulationContext::setSimMode(const SimulationMode sim_mode) {
+    sim_mode_ = sim_mode;
+}
+
+/*!
+ * @return TableUpdateMode ルーティングテーブル更新モード
+ */
+SimulationContext::TableUpdateMode SimulationContext::getTableUpdateMode()
+    const {
+    return table_update_mode_;
+}
+
+/*!
+ * @brief ルーティングテーブル更新モードの設定
+ * @param table_update_mode ルーティングテーブル更新モード
+ */
+void SimulationContext::setTableUpdateMode(
+    const TableUpdateMode table_update_mode) {
+    table_update_mode_ = table_update_mode;
+}
+
+/*!
+ * @return FloodingMode フラッディングモード
+ */
+SimulationContext::FloodingMode SimulationContext::getFloodingMode() const {
+    return flooding_mode_;
+}
+
+/*!
+ * @brief フラッディングモードの設定
+ * @param flooding_mode フラッディングモード
+ */
+void SimulationContext::setFloodingMode(const FloodingMode flooding_mode) {
+    flooding_mode_ = flooding_mode;
+}
+
+/*!
+ * @return RoutingMode ルーティング方式
+ */
+SimulationContext::RoutingMode SimulationContext::getRoutingMode() const {
+    return routing_mode_;
+}
+
+/*!
+ * @brief ルーティング方式の設定
+ * @param routing_mode ルーティング方式
+ */
+void SimulationContext::setRoutingMode(const RoutingMode routing_mode) {
+    routing_mode_ = routing_mode;
+}
+
+/*!
+ * @return double 接続可能距離
+ */
+double SimulationContext::getMaxComDistance() const {
+    return max_com_distance_;
+}
+
+/*!
+ * @return int 現在のフラッディングホップ数
+ */
+int SimulationContext::getFloodStep() const { return flood_step_; }
+
+/*!
+ * @brief フラッディングを次のホップへ進める
+ */
+void SimulationContext::nextFloodStep() { flood_step_++; }
+
+/*!
+ * @brief フラッディングホップ数を初期化する
+ */
+void SimulationContext::resetFloodStep() { flood_step_ = 0; }
+
+/*!
+ * @return EventScheduler* 事象駆動スケジューラ (同期送受信なら nullptr)
+ */
+EventScheduler *SimulationContext::getScheduler() const { return scheduler_; }
+
+/*!
+ * @brief 事象駆動スケジューラを設定する
+ * @param scheduler スケジューラ (nullptr で同期送受信に戻す)
+ */
+void SimulationContext::setScheduler(EventScheduler *scheduler) {
+    scheduler_ = scheduler;
+}
+
+/*!
+ * @brief デバイスのコンテナとペイロードを確保するメモリリソースを取得
+ * @details スレッド非安全なので、並列処理のタスクからは確保しないこと
+ * @return pmr::memory_resource* 試行ごとのアリーナのプール
+ */
+pmr::memory_resource *SimulationContext::getMemoryResource() { return &pool_; }
+
+/*!
+ * @brief アリーナから確保したメモリをまとめて解放する
+ * @details アリーナから確保したコンテナとペイロードがすべて破棄された後に
+ *          呼ぶこと
+ */
+void SimulationContext::releaseMemory() {
+    pool_.release();
+    arena_.release();
+}
@@ -0,0 +1,118 @@
+/*!
+ * @file SimulationContext.hpp
+ * @author tom96da
+ * @brief SimulationContext クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef SIMULATIONCONTEXT_HPP
+#define SIMULATIONCONTEXT_HPP
+
+#include <memory_resource>
+
+#include "EventScheduler.hpp"
+
+using namespace std;
+
+/* 接続可能距離 */
+const double MAX_COM_DISTANCE = 10.0;
+
+/* シミュレーションコンテキストクラス */
+/* 1つのシミュレーションに属するデバイスが共有するカウンタと設定を持つ */
+/* デバイスのコンテナとペイロードは試行ごとのアリーナから確保し、デバイスを
+   すべて削除したときにまとめて解放する */
+class SimulationContext {
+   public:
+    /* シミュレーションモード列挙型 */
+    enum class SimulationMode;
+    /* ルーティングテーブル更新モード列挙型 */
+    enum class TableUpdateMode;
+    /* フラッディングモード列挙型 */
+    enum class FloodingMode;
+    /* ルーティング方式列挙型 */
+    enum class RoutingMode;
+
+   private:
+    /* 累計パケット数 */
+    int num_total_packet_;
+    /* シミュレーションモード */
+    SimulationMode sim_mode_;
+    /* ルーティングテーブル更新モード */
+    TableUpdateMode table_update_mode_;
+    /* フラッディングモード */
+    FloodingMode flooding_mode_;
+    /* ルーティング方式 */
+    RoutingMode routing_mode_;
+    /* 接続可能距離 */
+    const double max_com_distance_;
+    /* 現在のフラッディングホップ数 */
+    int flood_step_;
+    /* 事象駆動シミュレーションのスケジューラ (nullptr なら同期送受信) */
+    EventScheduler *scheduler_;
+    /* 試行ごとのアリーナ (解放せずに切り出し、まとめて解放する) */
+    pmr::monotonic_buffer_resource arena_;
+    /* アリーナから切り出したブロックを再利用するプール (スレッド非安全) */
+    pmr::unsynchronized_pool_resource pool_;
+
+   public:
+    SimulationContext(const double max_com_distance = MAX_COM_DISTANCE);
+
+    int getTotalPacket() const;
+    int getNewSequenceNum();
+    void resetNumPacket();
+    void showTotalPacket() const;
+
+    SimulationMode getSimMode() const;
+    void setSimMode(const SimulationMode sim_mode);
+
+    TableUpdateMode getTableUpdateMode() const;
+    void setTableUpdateMode(const TableUpdateMode table_update_mode);
+
+    FloodingMode getFloodingMode() const;
+    void setFloodingMode(const FloodingMode flooding_mode);
+
+    RoutingMode getRoutingMode() const;
+    void setRoutingMode(const RoutingMode routing_mode);
+
+    double getMaxComDistance() const;
+
+    int getFloodStep() const;
+    void nextFloodStep();
+    void resetFloodStep();
+
+    EventScheduler *getScheduler() const;
+    void setScheduler(EventScheduler *scheduler);
+
+    pmr::memory_resource *getMemoryResource();
+    void releaseMemory();
+};
+
+/* シミュレーションモード */
+enum class SimulationContext::SimulationMode {
+    NONE,
+    CONVENTIONAL,             /* 既存手法 */
+    PROPOSAL_LONG_CONNECTION, /* 提案手法 遠距離接続 */
+    PROPOSAL_LONG_MPR         /* 提案手法 遠距離MPR 没案 */
+};
+
+/* ルーティングテーブル更新モード */
+enum class SimulationContext::TableUpdateMode {
+    FULL,     /* 毎回テーブル全体を送る */
+    TRIGGERED /* 変化したときだけ、変化したエントリを送る */
+};
+
+/* フラッディングモード */
+enum class SimulationContext::FloodingMode {
+    BLIND, /* 受信したすべてのデバイスが再送する */
+    MPR    /* 送信元に MPR として選ばれたデバイスだけが再送する (OLSR) */
+};
+
+/* ルーティング方式 */
+enum class SimulationContext::RoutingMode {
+    DISTANCE_VECTOR, /* 隣接デバイスとルーティングテーブルを交換する */
+    LINK_STATE       /* MPR が配る TC からトポロジーを集めて経路を求める */
+};
+
+#include "SimulationContext.cpp"
+
+#endif  // SIMULATIONCONTEXT_HPP
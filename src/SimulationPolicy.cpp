@@ -0,0 +1,72 @@
+/*!
+ * @file SimulationPolicy.cpp
+ * @author tom96da
+ * @brief シミュレーションモードの方針クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "SimulationPolicy.hpp"
+
+/*!
+ * @param willingness 隣接デバイスの willingness
+ * @param distance_of 隣接デバイスまでの距離を求める処理
+ * @return double 優先度 (すべて同じ)
+ */
+template <class DistanceOf>
+double UnspecifiedPolicy::getMPRPriority(const int, const DistanceOf &) {
+    return 0.0;
+}
+
+/*!
+ * @param willingness 隣接デバイスの willingness
+ * @param distance_of 隣接デバイスまでの距離を求める処理
+ * @return double 優先度 (willingness が高いほど優先)
+ */
+template <class DistanceOf>
+double ConventionalPolicy::getMPRPriority(const int willingness,
+                                          const DistanceOf &) {
+    return willingness;
+}
+
+/*!
+ * @param willingness 隣接デバイスの willingness
+ * @param distance_of 隣接デバイスまでの距離を求める処理
+ * @return double 優先度 (willingness が高いほど優先)
+ */
+template <class DistanceOf>
+double LongConnectionPolicy::getMPRPriority(const int willingness,
+                                            const DistanceOf &) {
+    return willingness;
+}
+
+/*!
+ * @param willingness 隣接デバイスの willingness
+ * @param distance_of 隣接デバイスまでの距離を求める処理
+ * @return double 優先度 (遠いほど優先)
+ */
+template <class DistanceOf>
+double LongMPRPolicy::getMPRPriority(const int, const DistanceOf &distance_of) {
+    return distance_of();
+}
+
+/*!
+ * @brief シミュレーションモードに対応する方針で処理を呼び出す
+ * @details モードの分岐はここだけで行い、試行の開始時に1度だけ呼ぶ
+ * @param sim_mode シミュレーションモード
+ * @param func 方針クラスのオブジェクトを受け取る処理
+ * @return func の戻り値
+ */
+template <class F>
+decltype(auto) dispatchSimMode(const SimulationContext::SimulationMode sim_mode,
+                               F &&func) {
+    switch (sim_mode) {
+        case SimulationContext::SimulationMode::CONVENTIONAL:
+            return func(ConventionalPolicy{});
+        case SimulationContext::SimulationMode::PROPOSAL_LONG_CONNECTION:
+            return func(LongConnectionPolicy{});
+        case SimulationContext::SimulationMode::PROPOSAL_LONG_MPR:
+            return func(LongMPRPolicy{});
+        default:
+            return func(UnspecifiedPolicy{});
+    }
+}
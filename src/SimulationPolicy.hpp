@@ -0,0 +1,70 @@
+/*!
+ * @file SimulationPolicy.hpp
+ * @author tom96da
+ * @brief シミュレーションモードの方針クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef SIMULATIONPOLICY_HPP
+#define SIMULATIONPOLICY_HPP
+
+#include "SimulationContext.hpp"
+
+using namespace std;
+
+/* シミュレーションモードの方針 */
+/* ネットワーク構築・MPR 選択の処理はこの方針をテンプレート引数に取り、
+   モードごとに別々にコンパイルされる。モードを増やすときは、列挙子と
+   方針クラスを追加し、dispatchSimMode に1行加える。
+   方針クラスが持つもの:
+   - MODE: シミュレーションモード
+   - IS_FAR_FIRST: 接続を遠い順に作るか (false ならランダム順)
+   - getMPRPriority: MPR に選ぶ隣接デバイスの優先度 (大きいほど優先)
+     距離は使う方針だけが distance_of を呼んで求める */
+
+/* モード未指定 */
+struct UnspecifiedPolicy {
+    static constexpr auto MODE = SimulationContext::SimulationMode::NONE;
+    static constexpr bool IS_FAR_FIRST = false;
+    template <class DistanceOf>
+    static double getMPRPriority(const int willingness,
+                                 const DistanceOf &distance_of);
+};
+
+/* 従来手法 */
+struct ConventionalPolicy {
+    static constexpr auto MODE =
+        SimulationContext::SimulationMode::CONVENTIONAL;
+    static constexpr bool IS_FAR_FIRST = false;
+    template <class DistanceOf>
+    static double getMPRPriority(const int willingness,
+                                 const DistanceOf &distance_of);
+};
+
+/* 提案手法 遠距離接続 */
+struct LongConnectionPolicy {
+    static constexpr auto MODE =
+        SimulationContext::SimulationMode::PROPOSAL_LONG_CONNECTION;
+    static constexpr bool IS_FAR_FIRST = true;
+    template <class DistanceOf>
+    static double getMPRPriority(const int willingness,
+                                 const DistanceOf &distance_of);
+};
+
+/* 提案手法 遠距離MPR 没案 */
+struct LongMPRPolicy {
+    static constexpr auto MODE =
+        SimulationContext::SimulationMode::PROPOSAL_LONG_MPR;
+    static constexpr bool IS_FAR_FIRST = false;
+    template <class DistanceOf>
+    static double getMPRPriority(const int willingness,
+                                 const DistanceOf &distance_of);
+};
+
+template <class F>
+decltype(auto) dispatchSimMode(const SimulationContext::SimulationMode sim_mode,
+                               F &&func);
+
+#include "SimulationPolicy.cpp"
+
+#endif  // SIMULATIONPOLICY_HPP
@@ -0,0 +1,192 @@
+/*!
+ * @file SpatialGrid.cpp
+ * @author tom96da
+ * @brief SpatialGrid クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "SpatialGrid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/* 一様格子による空間インデックスクラス */
+
+/*!
+ * @brief コンストラクタ (空の格子)
+ */
+SpatialGrid::SpatialGrid() : cell_size_{1.0}, num_cells_side_{1} {}
+
+/*!
+ * @brief コンストラクタ
+ * @param field_size フィールドサイズ
+ * @param cell_size セル幅
+ */
+SpatialGrid::SpatialGrid(const double field_size, const double cell_size)
+    : cell_size_{cell_size},
+      num_cells_side_{max(1, static_cast<int>(ceil(field_size / cell_size)))} {
+}
+
+/*!
+ * @param x x座標
+ * @param y y座標
+ * @return int 座標が属するセル番号
+ */
+int SpatialGrid::getCellIndex(const double x, const double y) const {
+    return toCell(y) * num_cells_side_ + toCell(x);
+}
+
+/*!
+ * @brief 座標から格子を構築する (デバイスIDは配列の添字)
+ * @param xs x座標
+ * @param ys y座標
+ */
+void SpatialGrid::build(const vector<double> &xs, const vector<double> &ys) {
+    const int num_devices = xs.size();
+    const int num_cells = num_cells_side_ * num_cells_side_;
+
+    /* セルごとに数え上げてから先頭位置を決める (計数ソート) */
+    cell_start_.assign(num_cells + 1, 0);
+    for (int id = 0; id < num_devices; id++) {
+        cell_start_[getCellIndex(xs[id], ys[id]) + 1]++;
+    }
+    for (int cell = 0; cell < num_cells; cell++) {
+        cell_start_[cell + 1] += cell_start_[cell];
+    }
+
+    /* 各セルの書き込み位置 */
+    auto cursor = cell_start_;
+    ids_.resize(num_devices);
+    xs_.resize(num_devices);
+    ys_.resize(num_devices);
+    for (int id = 0; id < num_devices; id++) {
+        const int index = cursor[getCellIndex(xs[id], ys[id])]++;
+        ids_[index] = id;
+        xs_[index] = xs[id];
+        ys_[index] = ys[id];
+    }
+}
+
+/*!
+ * @brief 周囲 3x3 セルにあるデバイスを近傍候補として取得する
+ * @param x x座標
+ * @param y y座標
+ * @param candidates 候補の格納先 (上書きされる)
+ */
+void SpatialGrid::getCandidates(const double x, const double y,
+                                vector<int> &candidates) const {
+    candidates.clear();
+    if (ids_.empty()) {
+        return;
+    }
+
+    const int cell_x = toCell(x), cell_y = toCell(y);
+    for (int cy = max(cell_y - 1, 0);
+         cy <= min(cell_y + 1, num_cells_side_ - 1); cy++) {
+        /* 同じ行の隣接セルは連続しているのでまとめて取り出す */
+        const int cell_begin = cy * num_cells_side_ + max(cell_x - 1, 0);
+        const int cell_end =
+            cy * num_cells_side_ + min(cell_x + 1, num_cells_side_ - 1);
+        candidates.insert(candidates.end(),
+                          ids_.begin() + cell_start_[cell_begin],
+                          ids_.begin() + cell_start_[cell_end + 1]);
+    }
+}
+
+/*!
+ * @brief 周囲 3x3 セルにあるデバイスのうち、距離が半径以内のものを取得する
+ * @details 半径はセル幅以下であること。自身の座標にあるデバイスも含む。
+ * @param x x座標
+ * @param y y座標
+ * @param radius 半径
+ * @param neighbors 近傍デバイスの格納先 (上書きされる, セル番号順)
+ */
+void SpatialGrid::getNeighbors(const double x, const double y,
+                               const double radius,
+                               vector<int> &neighbors) const {
+    neighbors.clear();
+    if (ids_.empty()) {
+        return;
+    }
+
+    const int cell_x = toCell(x), cell_y = toCell(y);
+    for (int cy = max(cell_y - 1, 0);
+         cy <= min(cell_y + 1, num_cells_side_ - 1); cy++) {
+        /* 同じ行の隣接セルは連続しているのでまとめて判定する */
+        const int cell_begin = cy * num_cells_side_ + max(cell_x - 1, 0);
+        const int cell_end =
+            cy * num_cells_side_ + min(cell_x + 1, num_cells_side_ - 1);
+        appendWithin(cell_start_[cell_begin], cell_start_[cell_end + 1], x, y,
+                     radius * radius, neighbors);
+    }
+}
+
+/*!
+ * @param coord 座標成分
+ * @return int セルの列 (行) 番号
+ */
+int SpatialGrid::toCell(const double coord) const {
+    return clamp(static_cast<int>(coord / cell_size_), 0, num_cells_side_ - 1);
+}
+
+/*!
+ * @brief セル番号順の範囲のうち、距離の2乗が半径の2乗以内のデバイスを追加する
+ * @details 距離の2乗をまとめて計算して比較し、範囲内のデバイスIDを1回の
+ *          走査で書き出す。AVX-512 では8台、AVX2 では4台ずつ判定し、
+ *          端数と SIMD のない環境ではスカラーで判定する。
+ * @param begin 範囲の先頭位置
+ * @param end 範囲の末尾位置の次
+ * @param x x座標
+ * @param y y座標
+ * @param squared_radius 半径の2乗
+ * @param neighbors 近傍デバイスの格納先 (追記される)
+ */
+void SpatialGrid::appendWithin(const int begin, const int end, const double x,
+                               const double y, const double squared_radius,
+                               vector<int> &neighbors) const {
+    int index = begin;
+
+#if defined(__AVX512F__)
+    const __m512d x_8 = _mm512_set1_pd(x), y_8 = _mm512_set1_pd(y);
+    const __m512d limit_8 = _mm512_set1_pd(squared_radius);
+    for (; index + 8 <= end; index += 8) {
+        const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(&xs_[index]), x_8);
+        const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(&ys_[index]), y_8);
+        const __m512d squared =
+            _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+        /* 範囲内のレーンのビットを下位から順に取り出す */
+        for (unsigned int mask =
+                 _mm512_cmp_pd_mask(squared, limit_8, _CMP_LE_OQ);
+             mask; mask &= mask - 1) {
+            neighbors.push_back(ids_[index + countr_zero(mask)]);
+        }
+    }
+#elif defined(__AVX2__)
+    const __m256d x_4 = _mm256_set1_pd(x), y_4 = _mm256_set1_pd(y);
+    const __m256d limit_4 = _mm256_set1_pd(squared_radius);
+    for (; index + 4 <= end; index += 4) {
+        const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&xs_[index]), x_4);
+        const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&ys_[index]), y_4);
+        const __m256d squared =
+            _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        /* 範囲内のレーンのビットを下位から順に取り出す */
+        for (unsigned int mask = _mm256_movemask_pd(
+                 _mm256_cmp_pd(squared, limit_4, _CMP_LE_OQ));
+             mask; mask &= mask - 1) {
+            neighbors.push_back(ids_[index + countr_zero(mask)]);
+        }
+    }
+#endif
+
+    for (; index < end; index++) {
+        const double dx = xs_[index] - x, dy = ys_[index] - y;
+        if (dx * dx + dy * dy <= squared_radius) {
+            neighbors.push_back(ids_[index]);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*!
+ * @file SpatialGrid.hpp
+ * @author tom96da
+ * @brief SpatialGrid クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef SPATIALGRID_HPP
+#define SPATIALGRID_HPP
+
+#include <vector>
+
+using namespace std;
+
+/* 一様格子による空間インデックスクラス */
+/* セル幅を接続可能距離にとり、近傍候補を周囲 3x3 セルに限定する。座標も
+   セル番号順に並べて持ち、同じ行の隣接セルの座標を連続した配列として
+   まとめて距離判定する (AVX-512 / AVX2 があれば SIMD で判定する)。 */
+class SpatialGrid {
+   private:
+    /* セル幅 */
+    double cell_size_;
+    /* 1辺のセル数 */
+    int num_cells_side_;
+    /* セルごとの先頭位置 (セル番号順, 末尾に総数) */
+    vector<int> cell_start_;
+    /* セル番号順に並べたデバイスID */
+    vector<int> ids_;
+    /* セル番号順に並べた x座標 */
+    vector<double> xs_;
+    /* セル番号順に並べた y座標 */
+    vector<double> ys_;
+
+   public:
+    SpatialGrid();
+    SpatialGrid(const double field_size, const double cell_size);
+
+    int getCellIndex(const double x, const double y) const;
+
+    void build(const vector<double> &xs, const vector<double> &ys);
+    void getCandidates(const double x, const double y,
+                       vector<int> &candidates) const;
+    void getNeighbors(const double x, const double y, const double radius,
+                      vector<int> &neighbors) const;
+
+   private:
+    int toCell(const double coord) const;
+    void appendWithin(const int begin, const int end, const double x,
+                      const double y, const double squared_radius,
+                      vector<int> &neighbors) const;
+};
+
+#include "SpatialGrid.cpp"
+
+#endif  // SPATIALGRID_HPP
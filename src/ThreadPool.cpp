@@ -0,0 +1,123 @@
+/*!
+ * @file ThreadPool.cpp
+ * @author tom96da
+ * @brief ThreadPool クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "ThreadPool.hpp"
+
+#include <atomic>
+
+/* スレッドプールクラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param num_threads スレッド数 デフォルト値: ハードウェアスレッド数
+ */
+ThreadPool::ThreadPool(const int num_threads) : stops_{false} {
+    for (int i = 0; i < max(num_threads, 1); i++) {
+        /* ワーカーを起動する */
+        workers_.emplace_back([this] { work(); });
+    }
+}
+
+/*!
+ * @brief デストラクタ
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex_tasks_);
+        stops_ = true;
+    }
+    cv_tasks_.notify_all();
+
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+/*!
+ * @return int スレッド数
+ */
+int ThreadPool::getNumThreads() const { return workers_.size(); }
+
+/*!
+ * @brief タスクを並列に実行し、すべての完了を待つ
+ * @details ワーカースレッドの中から呼び出してはならない (デッドロックする)
+ * @param num_task タスク数
+ * @param task タスク番号を受け取る処理
+ */
+void ThreadPool::parallelFor(const int num_task,
+                             const function<void(int)> &task) {
+    if (num_task <= 0) {
+        return;
+    }
+
+    /* 次に実行するタスク番号 */
+    atomic<int> index_next{0};
+    /* 実行中のワーカー数 */
+    int num_running = min(num_task, getNumThreads());
+    std::mutex mutex_done;
+    condition_variable cv_done;
+
+    {
+        lock_guard<std::mutex> lock(mutex_tasks_);
+        for (int i = 0; i < num_running; i++) {
+            tasks_.emplace([&] {
+                /* タスク番号を順に取り出して実行する */
+                for (int index = index_next++; index < num_task;
+                     index = index_next++) {
+                    task(index);
+                }
+
+                lock_guard<std::mutex> lock_done(mutex_done);
+                if (--num_running == 0) {
+                    cv_done.notify_one();
+                }
+            });
+        }
+    }
+    cv_tasks_.notify_all();
+
+    unique_lock<std::mutex> lock_done(mutex_done);
+    cv_done.wait(lock_done, [&] { return num_running == 0; });
+}
+
+/*!
+ * @brief タスクを並列に実行し、結果をタスク番号順に返す
+ * @param num_task タスク数
+ * @param task タスク番号を受け取り結果を返す処理
+ * @return vector タスク番号順の結果
+ */
+template <class F>
+auto ThreadPool::map(const int num_task, F &&task)
+    -> vector<invoke_result_t<F &, int>> {
+    /* 結果 */
+    vector<invoke_result_t<F &, int>> results(max(num_task, 0));
+    parallelFor(num_task,
+                [&](const int index) { results[index] = task(index); });
+
+    return results;
+}
+
+/*!
+ * @brief ワーカースレッドの処理
+ */
+void ThreadPool::work() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<std::mutex> lock(mutex_tasks_);
+            cv_tasks_.wait(lock, [this] { return stops_ || !tasks_.empty(); });
+            if (stops_ && tasks_.empty()) {
+                /* 終了指示があれば離脱 */
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+
+        task();
+    }
+}
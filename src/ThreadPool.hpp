@@ -0,0 +1,56 @@
+/*!
+ * @file ThreadPool.hpp
+ * @author tom96da
+ * @brief ThreadPool クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/* スレッドプールクラス */
+class ThreadPool {
+   private:
+    /* ワーカースレッド */
+    vector<thread> workers_;
+    /* タスクキュー */
+    queue<function<void()>> tasks_;
+    /* キューの排他制御 */
+    std::mutex mutex_tasks_;
+    /* タスク到着の通知 */
+    condition_variable cv_tasks_;
+    /* 終了フラグ */
+    bool stops_;
+
+   public:
+    ThreadPool(const int num_threads = thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int getNumThreads() const;
+
+    void parallelFor(const int num_task, const function<void(int)> &task);
+
+    template <class F>
+    auto map(const int num_task, F &&task)
+        -> vector<invoke_result_t<F &, int>>;
+
+   private:
+    void work();
+};
+
+#include "ThreadPool.cpp"
+
+#endif  // THREADPOOL_HPP
@@ -0,0 +1,88 @@
+/*!
+ * @file UnionFind.cpp
+ * @author tom96da
+ * @brief UnionFind クラスのソースファイル
+ * @date 2026-10-17
+ */
+
+#include "UnionFind.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+/* 素集合データ構造クラス */
+
+/*!
+ * @brief コンストラクタ
+ * @param num_elements 要素数
+ */
+UnionFind::UnionFind(const int num_elements)
+    : parent_(num_elements), size_(num_elements, 1), num_sets_{num_elements} {
+    iota(parent_.begin(), parent_.end(), 0);
+}
+
+/*!
+ * @brief 要素が属する集合の根を取得 (経路半減)
+ * @param element 要素
+ * @return int 根の要素
+ */
+int UnionFind::find(int element) {
+    while (parent_[element] != element) {
+        parent_[element] = parent_[parent_[element]];
+        element = parent_[element];
+    }
+
+    return element;
+}
+
+/*!
+ * @brief 要素が属する集合同士を併合する (大きさ優先)
+ * @param element_1 要素1
+ * @param element_2 要素2
+ * @retval true 併合した
+ * @retval false すでに同じ集合
+ */
+bool UnionFind::unite(const int element_1, const int element_2) {
+    int root_1 = find(element_1), root_2 = find(element_2);
+    if (root_1 == root_2) {
+        return false;
+    }
+
+    if (size_[root_1] < size_[root_2]) {
+        swap(root_1, root_2);
+    }
+    parent_[root_2] = root_1;
+    size_[root_1] += size_[root_2];
+    --num_sets_;
+
+    return true;
+}
+
+/*!
+ * @return int 集合の数
+ */
+int UnionFind::getNumSets() const { return num_sets_; }
+
+/*!
+ * @param element 要素
+ * @return int 要素が属する集合の大きさ
+ */
+int UnionFind::getSetSize(const int element) { return size_[find(element)]; }
+
+/*!
+ * @return vector<int> 各集合の大きさ (降順)
+ */
+vector<int> UnionFind::getSetSizes() {
+    vector<int> sizes;
+    for (int element = 0; element < static_cast<int>(parent_.size());
+         element++) {
+        if (find(element) == element) {
+            sizes.emplace_back(size_[element]);
+        }
+    }
+    sort(sizes.begin(), sizes.end(), greater<int>());
+
+    return sizes;
+}
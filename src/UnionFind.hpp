@@ -0,0 +1,38 @@
+/*!
+ * @file UnionFind.hpp
+ * @author tom96da
+ * @brief UnionFind クラスのヘッダファイル
+ * @date 2026-10-17
+ */
+
+#ifndef UNIONFIND_HPP
+#define UNIONFIND_HPP
+
+#include <vector>
+
+using namespace std;
+
+/* 素集合データ構造クラス */
+class UnionFind {
+   private:
+    /* 親の要素 */
+    vector<int> parent_;
+    /* 根の要素が持つ集合の大きさ */
+    vector<int> size_;
+    /* 集合の数 */
+    int num_sets_;
+
+   public:
+    UnionFind(const int num_elements);
+
+    int find(int element);
+    bool unite(const int element_1, const int element_2);
+
+    int getNumSets() const;
+    int getSetSize(const int element);
+    vector<int> getSetSizes();
+};
+
+#include "UnionFind.cpp"
+
+#endif  // UNIONFIND_HPP
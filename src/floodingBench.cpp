@@ -0,0 +1,159 @@
+/*!
+ * @file floodingBench.cpp
+ * @author tom96da
+ * @brief ブラインドフラッディングと MPR フラッディングの比較
+ * @details 同じトポロジー・同じ MPR 集合で、すべてのデバイスを順に開始デバイス
+ *          にしてフラッディングし、送信パケット数・重複受信数・到達台数・
+ *          実行時間を比べる。フロンティア駆動と一括のフラッディングの
+ *          実行時間と、ホップごとの平均到達台数も出力する。
+ *          始点ごとのホップごとの到達台数と、中心のデバイスからの
+ *          フラッディングの様子を ../tmp に CSV で記録する
+ *          (makeFloodingGif.py で描画する)。
+ * @date 2026-10-17
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "DeviceManager.hpp"
+
+using namespace std;
+
+int main() {
+    /* フィールドサイズ */
+    const double field_size = 60;
+    /* ノード数 */
+    const int num_node = 100;
+
+    std::cout << "field size: " << field_size << "x" << field_size << ", "
+              << "number of node: " << num_node << std::endl;
+
+    /*　マネージャー */
+    auto mgr = new MGR{field_size};
+    mgr->setSimMode(SIMMODE::CONVENTIONAL);
+
+    // 孤立しないネットワークを構築する
+    while (true) {
+        mgr->deleteDeviceAll();
+        mgr->addDevices(num_node);
+        mgr->buildNetwork();
+        if (mgr->isConnectedGraph()) {
+            break;
+        }
+    }
+
+    auto &context = mgr->getContext();
+
+    /* 座標記録ファイル (makeFloodingGif.py が読む形式) */
+    for (auto id : mgr->getDevicesList()) {
+        auto file = ofstream("../tmp/dev_pos" + to_string(id) + ".csv");
+        auto [x, y] = mgr->getPosition(id);
+        file << "x,y" << endl << x << ", " << y << endl;
+    }
+    /* 始点ごとのホップごとの到達台数の記録ファイル */
+    auto file_reach = ofstream("../tmp/reach_per_hop.csv");
+    file_reach << "flooding,source,hop,reach" << endl;
+    /* 中心のデバイスからのフラッディングの記録ファイル */
+    auto file_flooding = ofstream("../tmp/flooding.csv");
+    file_flooding << "flooding,hop,id" << endl;
+    const int id_center = mgr->getCentralDevice();
+
+    /* すべてのデバイスを順に開始デバイスにしてフラッディングする */
+    auto bench = [&](const string &label, const string &name) {
+        auto start = chrono::steady_clock::now();
+        double num_transmissions = 0, num_duplicates = 0, num_reach = 0;
+        int num_step_max = 0;
+
+        for (auto id : mgr->getDevicesList()) {
+            auto result = mgr->flooding(id);
+            num_transmissions += result.num_transmissions;
+            num_duplicates += result.num_duplicates;
+            num_reach += result.num_reach;
+            num_step_max = max(num_step_max, result.num_step);
+        }
+
+        auto time = chrono::duration_cast<chrono::microseconds>(
+                        chrono::steady_clock::now() - start)
+                        .count();
+        std::cout << label << ": " << num_transmissions / num_node
+                  << " packets, " << num_duplicates / num_node
+                  << " duplicates, " << num_reach / num_node
+                  << " devices reached (average per source), "
+                  << num_step_max << " hops at most, " << time << " us"
+                  << std::endl;
+
+        /* 同じフラッディングをフロンティア駆動ですべて同時に進める */
+        start = chrono::steady_clock::now();
+        mgr->floodingByFrontier(mgr->getDevicesList());
+        time = chrono::duration_cast<chrono::microseconds>(
+                   chrono::steady_clock::now() - start)
+                   .count();
+        std::cout << "  frontier    : " << time << " us" << std::endl;
+
+        /* 始点をビットに割り当てて一括で進める */
+        start = chrono::steady_clock::now();
+        auto results = mgr->floodingFromAll();
+        time = chrono::duration_cast<chrono::microseconds>(
+                   chrono::steady_clock::now() - start)
+                   .count();
+        /* 開始デバイスからのホップごとの平均到達台数 */
+        vector<double> reach_per_hop;
+        for (const auto &result : results) {
+            if (reach_per_hop.size() < result.reach_per_hop.size()) {
+                reach_per_hop.resize(result.reach_per_hop.size());
+            }
+            for (size_t hop = 0; hop < result.reach_per_hop.size(); hop++) {
+                reach_per_hop[hop] +=
+                    static_cast<double>(result.reach_per_hop[hop]) / num_node;
+            }
+        }
+        std::cout << "  batch       : " << time << " us, reach per hop [";
+        for (const auto reach : reach_per_hop) {
+            std::cout << reach << ", ";
+        }
+        std::cout << "\e[2D]" << std::endl;
+
+        /* 始点ごとのホップごとの到達台数を記録する (0ホップ目は始点) */
+        for (const auto &result : results) {
+            for (int hop = 0; auto reach : result.reach_per_hop) {
+                file_reach << name << "," << result.id_source << "," << hop++
+                           << "," << reach << endl;
+            }
+        }
+
+        /* 中心のデバイスからホップごとに到達したデバイスを記録する */
+        file_flooding << name << ",0," << id_center << endl;
+        const auto reached_per_hop = mgr->getReachedPerHop(id_center);
+        for (int hop = 1; const auto &reached : reached_per_hop) {
+            for (const auto id : reached) {
+                file_flooding << name << "," << hop << "," << id << endl;
+            }
+            ++hop;
+        }
+    };
+
+    /* MPR 集合はすべてのモードで hello から作ったものを使う */
+    mgr->sendHello();
+    mgr->makeMPR();
+
+    context.setFloodingMode(SimulationContext::FloodingMode::BLIND);
+    bench("blind         ", "blind");
+
+    context.setFloodingMode(SimulationContext::FloodingMode::MPR);
+    bench("MPR (makeMPR) ", "MPR");
+
+    {  // RFC 3626 の貪欲法で選んだ MPR 集合
+        auto MPRs = mgr->selectMPR(MPRSelector::Heuristic::RFC3626);
+        for (auto id : mgr->getDevicesList()) {
+            mgr->getDeviceById(id).setMPR(MPRs[id]);
+        }
+        bench("MPR (RFC 3626)", "RFC3626");
+    }
+
+    delete mgr;
+
+    return 0;
+}
@@ -13,13 +13,16 @@
 
 #endif
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <tuple>
 #include <vector>
 
 #include "Device.hpp"
 #include "DeviceManager.hpp"
+#include "ThreadPool.hpp"
 #include "pbar.hpp"
 
 using namespace std;
@@ -33,13 +36,20 @@ int main() {
     auto files = vector<ofstream>{};
     /* 試行回数 */
     const int num_repeat = 1000;
+    /* ルーティングテーブル更新モード (TRIGGERED で変化したエントリだけを送る) */
+    const auto table_update_mode = SimulationContext::TableUpdateMode::FULL;
+    /* 更新モード名 (結果に記録する) */
+    const string table_update_mode_name =
+        table_update_mode == SimulationContext::TableUpdateMode::FULL
+            ? "FULL"
+            : "TRIGGERED";
     /* 結果 */
     vector<tuple<int, double, int64_t, vector<map<int, double>>>>
         result_convetntional, result_proposal;
 
     /* 座標記録ファイル作成 */
-    auto newCsv = [&](MGR *mgr) {
-        for (auto id : mgr->getDevicesList()) {
+    auto newCsv = [&](const vector<pair<double, double>> &positions) {
+        for (int id = 0; id < static_cast<int>(positions.size()); id++) {
             string fname = "../tmp/position/device" + to_string(id) + ".csv";
             auto &file = files.emplace_back(fname);
             file << "x,y" << endl;
@@ -47,14 +57,13 @@ int main() {
     };
 
     /* ファイルに座標書き込み */
-    auto writeCsv = [&](MGR *mgr) {
+    auto writeCsv = [&](const vector<pair<double, double>> &positions) {
         if (files.empty()) {
-            newCsv(mgr);
+            newCsv(positions);
         }
 
-        for (auto id : mgr->getDevicesList()) {
-            auto [x, y] = mgr->getPosition(id);
-            files[id] << x << ", " << y << endl;
+        for (int id = 0; auto [x, y] : positions) {
+            files[id++] << x << ", " << y << endl;
         }
     };
 
@@ -111,108 +120,130 @@ int main() {
 
     /* シミュレーション開始 */
 
+    /* 試行を並列実行するスレッドプール */
+    auto pool = ThreadPool();
+    /* 乱数シードの基準値 */
+    const unsigned int seed_base = random_device{}();
+
     /* パラメータ表示 */
     std::cout << "field size: " << field_size << "x" << field_size << ", "
               << "number of node: " << num_node << ", "
-              << "repeat: " << num_repeat << std::endl;
+              << "repeat: " << num_repeat << ", "
+              << "table update: " << table_update_mode_name << ", "
+              << "threads: " << pool.getNumThreads() << std::endl;
 
     auto pbar = PBar();
     auto &pb_repeat = pbar.add();
-    auto &pb_proposal = pbar.add();
-    auto &pb_conventional = pbar.add();
     pb_repeat.set_title("Simulation progress");
     pb_repeat.monitarTime();
-    pb_conventional.set_title("CONVENTIONAL");
-    pb_proposal.set_title("LONG_CONNECTION");
 
     int count_repeat = 0;
+    /* 完了試行数の排他制御 */
+    std::mutex mutex_repeat;
     pb_repeat.clear();
     pb_repeat.start(num_repeat, count_repeat);
 
-    for (; count_repeat < num_repeat;) {
-        pb_conventional.clear();
-        pb_proposal.clear();
-
-        /*　マネージャー */
-        auto mgr = new MGR{field_size};
-        mgr->setSimMode(SIMMODE::CONVENTIONAL);
+    /* 完成するまでテーブルを更新する */
+    auto makingTableUntilcomplete = [num_node](MGR &mgr)
+        -> tuple<int, double, int64_t, vector<map<int, double>>> {
+        int num_packet_start = mgr.getContext().getTotalPacket();
+        int num_packet_end = 0;
+        int num_done = 0;
+        int num_update = 0;
+        auto start = chrono::steady_clock::now();
 
-        /* 孤立した端末がないネットワークを構築する */
         while (true) {
-            /* 孤立するノードがないネットワークができるまで繰り返す */
-            mgr->deleteDeviceAll();
-            mgr->addDevices(num_node);
-            mgr->buildNetwork();
-            const auto [_, num_member] = mgr->flooding(45);
-            if (num_member == num_node) {
-                /* 孤立するノードがなければ抜ける */
+            mgr.sendTable();
+            num_done = num_node - mgr.makeTable();
+            if (num_done < num_node) {
+                num_packet_end = mgr.getContext().getTotalPacket();
+                ++num_update;
+            } else {
                 break;
             }
         }
 
-        writeCsv(mgr);
-
-        /* 完成するまでテーブルを更新する */
-        auto makingTableUntilcomplete =
-            [&mgr, num_node](
-                std::vector<std::tuple<int, double, int64_t,
-                                       vector<map<int, double>>>> &result,
-                ProgressBar::BarBody &pb) {
-                int num_packet_start = Device::getTotalPacket();
-                int num_packet_end = 0;
-                int num_done = 0;
-                int num_update = 0;
-                pb.start(num_node, num_done);
-
-                while (true) {
-                    mgr->sendTable();
-                    num_done = num_node - mgr->makeTable();
-                    if (num_done < num_node) {
-                        num_packet_end = Device::getTotalPacket();
-                        ++num_update;
-                    } else {
-                        break;
-                    }
+        auto time = chrono::duration_cast<chrono::milliseconds>(
+                        chrono::steady_clock::now() - start)
+                        .count();
+        return {num_packet_end - num_packet_start, num_update, time,
+                mgr.calculateTableFrequency()};
+    };
+
+    /* 1試行分のシミュレーション (ワーカーごとに独立したマネージャーを使う) */
+    auto runTrial = [&](const int index) {
+        /*　マネージャー */
+        MGR mgr{field_size, seed_base + index};
+        mgr.getContext().setTableUpdateMode(table_update_mode);
+        /* 各手法の結果 */
+        tuple<int, double, int64_t, vector<map<int, double>>> conventional,
+            proposal;
+        /* 座標 */
+        vector<pair<double, double>> positions;
+
+        while (true) {
+            mgr.setSimMode(SIMMODE::CONVENTIONAL);
+
+            /* 孤立した端末がないネットワークを構築する */
+            while (true) {
+                /* 孤立するノードがないネットワークができるまで繰り返す */
+                mgr.deleteDeviceAll();
+                mgr.addDevices(num_node);
+                mgr.buildNetwork();
+                if (mgr.isConnectedGraph()) {
+                    /* 孤立するノードがなければ抜ける */
+                    break;
                 }
+            }
 
-                pb.close();
-                result.emplace_back(num_packet_end - num_packet_start,
-                                    num_update, pb.getTime_millsec(),
-                                    mgr->calculateTableFrequency());
-            };
+            positions.clear();
+            for (auto id : mgr.getDevicesList()) {
+                positions.emplace_back(mgr.getPosition(id));
+            }
 
-        { /* 既存手法 */
-            mgr->sendHello();
-            mgr->makeMPR();
-            // mgr->showMPR(0);
+            { /* 既存手法 */
+                mgr.sendHello();
+                mgr.makeMPR();
 
-            makingTableUntilcomplete(result_convetntional, pb_conventional);
-        }
+                conventional = makingTableUntilcomplete(mgr);
+            }
+
+            mgr.clearDevice();
+            mgr.resetNetwork();
+
+            { /* 提案手法 遠距離選択接続 */
+                mgr.setSimMode(SIMMODE::PROPOSAL_LONG_CONNECTION);
+                mgr.buildNetwork();
+                if (!mgr.isConnectedGraph()) {
+                    /* 孤立するノードがあれば従来手法の結果を捨ててやり直す */
+                    continue;
+                }
 
-        mgr->clearDevice();
-        mgr->resetNetwork();
-
-        { /* 提案手法 遠距離選択接続 */
-            mgr->setSimMode(SIMMODE::PROPOSAL_LONG_CONNECTION);
-            mgr->buildNetwork();
-            const auto [_, num_member] = mgr->flooding(45);
-            if (num_member != num_node) {
-                /* 孤立するノードがあれば従来手法の結果を消してループに戻る */
-                result_convetntional.pop_back();
-                continue;
+                mgr.sendHello();
+                mgr.makeMPR();
+
+                proposal = makingTableUntilcomplete(mgr);
             }
 
-            mgr->sendHello();
-            mgr->makeMPR();
-            // mgr->showMPR(0);
+            break;
+        }
 
-            makingTableUntilcomplete(result_proposal, pb_proposal);
+        {
+            lock_guard<std::mutex> lock(mutex_repeat);
+            ++count_repeat;
         }
 
-        ++count_repeat;
+        return tuple{conventional, proposal, positions};
+    };
 
-        delete mgr;
+    /* 試行を並列に実行し、試行番号順に結果を集める */
+    for (auto &[conventional, proposal, positions] :
+         pool.map(num_repeat, runTrial)) {
+        writeCsv(positions);
+        result_convetntional.emplace_back(std::move(conventional));
+        result_proposal.emplace_back(std::move(proposal));
     }
+
     pb_repeat.close();
     pbar.erase();
     auto time = pb_repeat.getTime_sec();
@@ -240,7 +271,8 @@ int main() {
     /* パラメータ書き込み */
     file_result << "field size;" << field_size << "x" << field_size << ","
                 << "number of node;" << num_node << ","
-                << "repeat;" << num_repeat << std::endl;
+                << "repeat;" << num_repeat << ","
+                << "table update;" << table_update_mode_name << std::endl;
     file_result << "METHOD;packets,update,time[ms]" << std::endl;
 
     /* 平均書き込み */
@@ -262,7 +294,8 @@ int main() {
     auto &file_frequency = files.emplace_back("../tmp/frequency.csv");
     file_frequency << "field size;" << field_size << "x" << field_size << ","
                    << "number of node;" << num_node << ","
-                   << "repeat;" << num_repeat << std::endl;
+                   << "repeat;" << num_repeat << ","
+                   << "table update;" << table_update_mode_name << std::endl;
     file_frequency << ",central,, ,middle,, ,edge," << std::endl;
     file_frequency << "hops,conventional,proposal, ,conventional,"
                       "proposal, ,conventional,proposal"
@@ -20,18 +20,15 @@ dev_y = []
 pos_x = []
 pos_y = []
 
-source = [45]
-received = [
-    [72, 82, 86, 87, 90, 99],
-    [5, 8, 12, 14, 21, 22, 23, 29, 46, 58, 61, 62, 65, 67, 71, 88, 94, 97],
-    [0, 11, 13, 15, 17, 20, 31, 35, 36, 37, 38, 41, 47,
-        49, 50, 55, 56, 63, 74, 79, 81, 83, 92, 93],
-    [2, 3, 4, 9, 16, 24, 27, 39, 40, 51, 54, 66, 70, 75, 78, 91],
-    [10, 18, 19, 33, 34, 64, 73, 76, 77, 84, 85, 95],
-    [1, 6, 7, 25, 42, 44, 48, 53, 60, 80],
-    [28, 30, 43, 52, 57, 59, 68, 89, 96, 98],
-    [26, 32, 69],
-]
+# 描画するフラッディング (floodingBench の blind, MPR, RFC3626)
+flooding = "MPR"
+
+# floodingBench が記録したホップごとに到達したデバイス
+data = pd.read_csv("../tmp/flooding.csv")
+data = data[data['flooding'] == flooding]
+source = list(data[data['hop'] == 0]['id'])
+received = [list(data[data['hop'] == hop]['id'])
+            for hop in range(1, data['hop'].max() + 1)]
 
 num_step = len(received) + 1
 
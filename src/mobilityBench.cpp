@@ -0,0 +1,115 @@
+/*!
+ * @file mobilityBench.cpp
+ * @author tom96da
+ * @brief デバイスの移動に合わせた経路表の修復の確認
+ * @details 収束したネットワークでデバイスを移動させ、変化した接続だけを
+ *          繋ぎ直して経路表を部分的に修復し、再収束させる。これを繰り返し、
+ *          ステップあたりの接続の変化数・ラウンド数・制御パケット数・
+ *          実行時間と、BFS で求めた最短経路と食い違うエントリ数を出力する。
+ *          距離ベクトル方式のテーブル更新モードごとと、リンク状態方式とで、
+ *          同じ乱数シードで同じ移動を再現して比べる。
+ * @date 2026-10-17
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <tuple>
+
+#include "DeviceManager.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+int main() {
+    /* フィールドサイズ */
+    const double field_size = 60;
+    /* ノード数 */
+    const int num_node = 100;
+    /* 移動ステップ数 */
+    const int num_step = 100;
+    /* 乱数シード (モード間で同じネットワークと移動にする) */
+    const unsigned int seed = 1;
+
+    std::cout << "field size: " << field_size << "x" << field_size << ", "
+              << "number of node: " << num_node << ", "
+              << "number of step: " << num_step << std::endl;
+
+    /* スレッドプール */
+    auto pool = ThreadPool();
+
+    using RoutingMode = SimulationContext::RoutingMode;
+    using TableUpdateMode = SimulationContext::TableUpdateMode;
+
+    for (const auto &[routing_mode, table_update_mode, label] :
+         {tuple{RoutingMode::DISTANCE_VECTOR, TableUpdateMode::FULL,
+                "distance vector (full)     "},
+          tuple{RoutingMode::DISTANCE_VECTOR, TableUpdateMode::TRIGGERED,
+                "distance vector (triggered)"},
+          tuple{RoutingMode::LINK_STATE, TableUpdateMode::FULL,
+                "link state                 "}}) {
+        /*　マネージャー */
+        auto mgr = new MGR{field_size, seed};
+        mgr->setSimMode(SIMMODE::CONVENTIONAL);
+        auto &context = mgr->getContext();
+        context.setRoutingMode(routing_mode);
+        context.setTableUpdateMode(table_update_mode);
+
+        // 孤立しないネットワークを構築する
+        while (true) {
+            mgr->deleteDeviceAll();
+            mgr->addDevices(num_node);
+            mgr->buildNetwork();
+            if (mgr->isConnectedGraph()) {
+                break;
+            }
+        }
+
+        /* 送信がなくなるまで経路表を交換し、ラウンド数を返す */
+        auto converge = [&]() {
+            int num_round = 0;
+            while (true) {
+                mgr->sendTable();
+                ++num_round;
+                if (mgr->makeTable(&pool) == 0) {
+                    break;
+                }
+            }
+            return num_round;
+        };
+
+        mgr->sendHello();
+        mgr->makeMPR();
+        converge();
+
+        double num_change = 0, num_round = 0, num_packet = 0;
+        int num_wrong = 0;
+        int64_t time = 0;
+        for (int step = 0; step < num_step; step++) {
+            auto start = chrono::steady_clock::now();
+            int num_packet_start = context.getTotalPacket();
+
+            /* 移動 → 接続の修復 → 再収束 */
+            auto changes = mgr->updatePositionAll();
+            mgr->repairNetwork(changes);
+            num_round += converge();
+
+            time += chrono::duration_cast<chrono::microseconds>(
+                        chrono::steady_clock::now() - start)
+                        .count();
+            num_change += changes.size();
+            num_packet += context.getTotalPacket() - num_packet_start;
+            num_wrong += mgr->verifyTable();
+        }
+
+        std::cout << label << ": " << num_change / num_step
+                  << " link changes, " << num_round / num_step << " rounds, "
+                  << num_packet / num_step << " packets, "
+                  << time / num_step << " us per step, " << num_wrong
+                  << " wrong entries in total" << std::endl;
+
+        delete mgr;
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*!
+ * @file routingBench.cpp
+ * @author tom96da
+ * @brief 距離ベクトル方式とリンク状態方式の経路表作成の比較
+ * @details 同じトポロジーで、ルーティングテーブルを交換する方式と、MPR が
+ *          配る TC から経路を求める方式 (OLSR) を比べる。制御パケット数、
+ *          収束までのラウンド数と時刻、デバイスあたりの保持情報量を出力する。
+ * @date 2026-10-17
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "DeviceManager.hpp"
+#include "EventScheduler.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+int main() {
+    /* フィールドサイズ */
+    const double field_size = 60;
+    /* ノード数 */
+    const int num_node = 100;
+
+    std::cout << "field size: " << field_size << "x" << field_size << ", "
+              << "number of node: " << num_node << std::endl;
+
+    /* スレッドプール */
+    auto pool = ThreadPool();
+
+    /*　マネージャー */
+    auto mgr = new MGR{field_size};
+    mgr->setSimMode(SIMMODE::CONVENTIONAL);
+
+    // 孤立しないネットワークを構築する
+    while (true) {
+        mgr->deleteDeviceAll();
+        mgr->addDevices(num_node);
+        mgr->buildNetwork();
+        if (mgr->isConnectedGraph()) {
+            break;
+        }
+    }
+
+    auto &context = mgr->getContext();
+    using RoutingMode = SimulationContext::RoutingMode;
+
+    for (const auto routing_mode :
+         {RoutingMode::DISTANCE_VECTOR, RoutingMode::LINK_STATE}) {
+        context.setRoutingMode(routing_mode);
+        const string label = routing_mode == RoutingMode::DISTANCE_VECTOR
+                                 ? "distance vector"
+                                 : "link state     ";
+
+        {  // ラウンド単位
+            mgr->clearDevice();
+            auto start = chrono::steady_clock::now();
+            int num_packet_start = context.getTotalPacket();
+            int num_update = 0;
+
+            mgr->sendHello();
+            mgr->makeMPR();
+            while (true) {
+                mgr->sendTable();
+                if (mgr->makeTable(&pool) == 0) {
+                    break;
+                }
+                ++num_update;
+            }
+
+            auto time = chrono::duration_cast<chrono::microseconds>(
+                            chrono::steady_clock::now() - start)
+                            .count();
+
+            /* デバイスあたりのテーブルのエントリ数と TC の組の数 */
+            double num_entry = 0, num_tuple = 0;
+            for (auto id : mgr->getDevicesList()) {
+                auto &device = mgr->getDeviceById(id);
+                num_entry += device.getTable().getNumEntry();
+                num_tuple += device.getNumTopologyTuple();
+            }
+
+            std::cout << label << ": " << num_update << " rounds, "
+                      << context.getTotalPacket() - num_packet_start
+                      << " packets, " << time << " us, "
+                      << mgr->verifyTable() << " wrong entries, "
+                      << num_entry / num_node << " entries + "
+                      << num_tuple / num_node << " topology tuples per device"
+                      << std::endl;
+        }
+
+        {  // 事象駆動
+            mgr->clearDevice();
+            /* スケジューラ リンク遅延は 1ms + 距離に比例 */
+            auto scheduler = EventScheduler();
+            scheduler.setLinkLatency([&](const int id_1, const int id_2) {
+                return 1.0 + mgr->getDistance(id_1, id_2) / MAX_COM_DISTANCE;
+            });
+
+            int num_packet_start = context.getTotalPacket();
+            double time_converged = mgr->makeTableEventDriven(scheduler);
+
+            std::cout << "  event-driven : converged at " << time_converged
+                      << " ms (simulated), "
+                      << context.getTotalPacket() - num_packet_start
+                      << " packets, " << mgr->verifyTable()
+                      << " wrong entries" << std::endl;
+        }
+    }
+
+    delete mgr;
+
+    return 0;
+}
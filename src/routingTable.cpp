@@ -6,16 +6,24 @@
  */
 #include "routingTable.hpp"
 
+#include <algorithm>
+#include <bit>
+
 /* ルーティングテーブルクラス */
 
 /* コンストラクタ */
-RoutingTable::RoutingTable() {}
+RoutingTable::RoutingTable() : generation_{0} {}
 
 /*!
  * @return 総エントリ数
  */
 int RoutingTable::getNumEntry() const { return table_.size(); }
 
+/*!
+ * @return 世代
+ */
+int RoutingTable::getGeneration() const { return generation_; }
+
 /*!
  * @param id_dest 宛先デバイスID
  * @return 次ホップデバイスID
@@ -67,6 +75,16 @@ bool RoutingTable::hasEntry(const int id_dest) const {
     return table_.count(id_dest);
 }
 
+/*!
+ * @brief 宛先のエントリが有効か取得
+ * @param id_dest 宛先デバイスID
+ * @retval true 有効なエントリがある
+ * @retval false エントリがないか、無効
+ */
+bool RoutingTable::isEntryValid(const int id_dest) const {
+    return hasEntry(id_dest) && table_.at(id_dest).isValid();
+}
+
 /*!
  * @brief エントリの更新
  * @param id_dest 宛先デバイスID
@@ -78,15 +96,16 @@ bool RoutingTable::hasEntry(const int id_dest) const {
 bool RoutingTable::setEntry(const int id_dest, const int id_nextHop,
                             const int distance) {
     if (table_.count(id_dest)) {
-        // 既にエントリが存在する場合は、距離が近ければ更新する
-        if (table_.at(id_dest).getNumHop() > distance) {
-            table_[id_dest].setEntry(id_nextHop, distance);
+        // 既にエントリが存在する場合は、距離が近いか無効なら更新する
+        if (!table_.at(id_dest).isValid() ||
+            table_.at(id_dest).getNumHop() > distance) {
+            table_[id_dest].setEntry(id_nextHop, distance, ++generation_);
         } else {
             return false;
         }
     } else {
         // エントリが存在しない場合は、新たに作成する
-        table_.emplace(id_dest, Entry(id_nextHop, distance));
+        table_.emplace(id_dest, Entry(id_nextHop, distance, ++generation_));
     }
 
     return true;
@@ -98,14 +117,234 @@ bool RoutingTable::setEntry(const int id_dest, const int id_nextHop,
  */
 void RoutingTable::markEntryInvalid(const int id_dest) {
     if (table_.count(id_dest)) {
-        table_.at(id_dest).markInvalid();
+        table_.at(id_dest).markInvalid(++generation_);
+    }
+}
+
+/*!
+ * @brief 有効なエントリを変えずに世代だけ進め、次の差分送信に含める
+ * @param id_dest 宛先デバイスID
+ */
+void RoutingTable::refreshEntry(const int id_dest) {
+    if (isEntryValid(id_dest)) {
+        auto &entry = table_.at(id_dest);
+        entry.setEntry(entry.getIdNextHop(), entry.getNumHop(), ++generation_);
     }
 }
 
 /*!
  * @brief すべてのエントリをクリアする
  */
-void RoutingTable::clearEntryAll() { table_.clear(); }
+void RoutingTable::clearEntryAll() {
+    table_.clear();
+    generation_ = 0;
+}
+
+/*!
+ * @brief 指定した世代より後に変化した有効なエントリだけのテーブルを作る
+ * @param since_generation 基準の世代
+ * @return RoutingTable 差分テーブル
+ */
+RoutingTable RoutingTable::makeDelta(const int since_generation) const {
+    RoutingTable delta;
+    for (const auto &[id_dest, entry] : table_) {
+        if (entry.isValid() && entry.getGeneration() > since_generation) {
+            delta.setEntry(id_dest, entry.getIdNextHop(), entry.getNumHop());
+        }
+    }
+
+    return delta;
+}
+
+/*!
+ * @brief すべてのエントリを宛先ID順に走査する
+ * @param func 宛先ID とエントリを受け取る処理
+ */
+template <class F>
+void RoutingTable::forEachEntry(F &&func) const {
+    for (const auto &[id_dest, entry] : table_) {
+        func(id_dest, entry);
+    }
+}
+
+/* ID を添字とする密なルーティングテーブルクラス */
+
+/* コンストラクタ */
+FlatRoutingTable::FlatRoutingTable() : num_entry_{0}, generation_{0} {}
+
+/*!
+ * @return 総エントリ数
+ */
+int FlatRoutingTable::getNumEntry() const { return num_entry_; }
+
+/*!
+ * @return 世代
+ */
+int FlatRoutingTable::getGeneration() const { return generation_; }
+
+/*!
+ * @param id_dest 宛先デバイスID
+ * @return 次ホップデバイスID
+ */
+int FlatRoutingTable::getIdNextHop(const int id_dest) const {
+    if (!hasEntry(id_dest)) {
+        return -1;
+    }
+
+    return entries_[id_dest].getIdNextHop();
+}
+
+/*!
+ * @param id_dest 宛先デバイスID
+ * @return 宛先デバイスまでのホップ距離
+ */
+int FlatRoutingTable::getNumHop(const int id_dest) const {
+    if (!hasEntry(id_dest)) {
+        return -1;
+    }
+
+    return entries_[id_dest].getNumHop();
+}
+
+/*!
+ * @return エントリ済みデバイスのID
+ */
+vector<int> FlatRoutingTable::getDestinations() const {
+    vector<int> destinations;
+    destinations.reserve(num_entry_);
+    forEachEntry([&](const int id_dest, const Entry &) {
+        destinations.push_back(id_dest);
+    });
+
+    return destinations;
+}
+
+/*!
+ * @brief 宛先のエントリがあるかを取得
+ * @param id_dest
+ * @retval true 存在する
+ * @retval false 存在しない
+ */
+bool FlatRoutingTable::hasEntry(const int id_dest) const {
+    if (id_dest < 0 || id_dest >= static_cast<int>(entries_.size())) {
+        return false;
+    }
+
+    return (has_entry_[id_dest / 64] >> (id_dest % 64)) & 1;
+}
+
+/*!
+ * @brief 宛先のエントリが有効か取得
+ * @param id_dest 宛先デバイスID
+ * @retval true 有効なエントリがある
+ * @retval false エントリがないか、無効
+ */
+bool FlatRoutingTable::isEntryValid(const int id_dest) const {
+    return hasEntry(id_dest) && entries_[id_dest].isValid();
+}
+
+/*!
+ * @brief エントリの更新
+ * @param id_dest 宛先デバイスID
+ * @param id_nextHop 次ホップデバイスのID
+ * @param distance 次ホップデバイスの距離
+ * @retval true 更新あり
+ * @retval false 更新無し
+ */
+bool FlatRoutingTable::setEntry(const int id_dest, const int id_nextHop,
+                                const int distance) {
+    if (hasEntry(id_dest)) {
+        // 既にエントリが存在する場合は、距離が近いか無効なら更新する
+        auto &entry = entries_[id_dest];
+        if (entry.isValid() && entry.getNumHop() <= distance) {
+            return false;
+        }
+        entry.setEntry(id_nextHop, distance, ++generation_);
+    } else {
+        // エントリが存在しない場合は、新たに作成する
+        reserveEntry(id_dest);
+        entries_[id_dest] = Entry(id_nextHop, distance, ++generation_);
+        has_entry_[id_dest / 64] |= uint64_t{1} << (id_dest % 64);
+        ++num_entry_;
+    }
+
+    return true;
+}
+
+/*!
+ * @brief 宛先に対するエントリを無効にする
+ * @param id_dest 宛先デバイスID
+ */
+void FlatRoutingTable::markEntryInvalid(const int id_dest) {
+    if (hasEntry(id_dest)) {
+        entries_[id_dest].markInvalid(++generation_);
+    }
+}
+
+/*!
+ * @brief 有効なエントリを変えずに世代だけ進め、次の差分送信に含める
+ * @param id_dest 宛先デバイスID
+ */
+void FlatRoutingTable::refreshEntry(const int id_dest) {
+    if (isEntryValid(id_dest)) {
+        auto &entry = entries_[id_dest];
+        entry.setEntry(entry.getIdNextHop(), entry.getNumHop(), ++generation_);
+    }
+}
+
+/*!
+ * @brief すべてのエントリをクリアする (領域は再利用する)
+ */
+void FlatRoutingTable::clearEntryAll() {
+    fill(has_entry_.begin(), has_entry_.end(), 0);
+    num_entry_ = 0;
+    generation_ = 0;
+}
+
+/*!
+ * @brief すべてのエントリを宛先ID順に走査する
+ * @param func 宛先ID とエントリを受け取る処理
+ */
+template <class F>
+void FlatRoutingTable::forEachEntry(F &&func) const {
+    for (int word = 0; word < static_cast<int>(has_entry_.size()); word++) {
+        for (uint64_t bits = has_entry_[word]; bits; bits &= bits - 1) {
+            /* 立っているビットを下位から順に取り出す */
+            const int id_dest = word * 64 + countr_zero(bits);
+            func(id_dest, entries_[id_dest]);
+        }
+    }
+}
+
+/*!
+ * @brief 指定した世代より後に変化した有効なエントリだけのテーブルを作る
+ * @param since_generation 基準の世代
+ * @return FlatRoutingTable 差分テーブル
+ */
+FlatRoutingTable FlatRoutingTable::makeDelta(
+    const int since_generation) const {
+    FlatRoutingTable delta;
+    forEachEntry([&](const int id_dest, const Entry &entry) {
+        if (entry.isValid() && entry.getGeneration() > since_generation) {
+            delta.setEntry(id_dest, entry.getIdNextHop(), entry.getNumHop());
+        }
+    });
+
+    return delta;
+}
+
+/*!
+ * @brief 宛先IDまでのエントリ領域を確保する
+ * @param id_dest 宛先デバイスID
+ */
+void FlatRoutingTable::reserveEntry(const int id_dest) {
+    if (id_dest < static_cast<int>(entries_.size())) {
+        return;
+    }
+
+    entries_.resize(id_dest + 1);
+    has_entry_.resize(id_dest / 64 + 1, 0);
+}
 
 /* 各デバイスのエントリクラス */
 
@@ -113,9 +352,14 @@ void RoutingTable::clearEntryAll() { table_.clear(); }
  * @brief コンストラクタ
  * @param id_nextHop 次ホップデバイスのID
  * @param distance 次ホップデバイスの距離
+ * @param generation テーブルの世代
  */
-RoutingTable::Entry::Entry(const int id_nextHop, const int distance)
-    : id_nextHop_{id_nextHop}, num_hop_{distance}, isValid_{true} {}
+RoutingTable::Entry::Entry(const int id_nextHop, const int distance,
+                           const int generation)
+    : id_nextHop_{id_nextHop},
+      num_hop_{distance},
+      isValid_{true},
+      generation_{generation} {}
 
 /*!
  * @return 次ホップデバイスのID
@@ -134,18 +378,30 @@ int RoutingTable::Entry::getNumHop() const { return num_hop_; }
  */
 bool RoutingTable::Entry::isValid() const { return isValid_; }
 
+/*!
+ * @return 最後に変化したときのテーブルの世代
+ */
+int RoutingTable::Entry::getGeneration() const { return generation_; }
+
 /*!
  * @brief エントリの更新
  * @param id_nextHop 次のホップデバイスのID
  * @param distance 次ポップデバイスの距離
+ * @param generation テーブルの世代
  */
-void RoutingTable::Entry::setEntry(const int id_nextHop, const int distance) {
+void RoutingTable::Entry::setEntry(const int id_nextHop, const int distance,
+                                   const int generation) {
     id_nextHop_ = id_nextHop;
     num_hop_ = distance;
     isValid_ = true;
+    generation_ = generation;
 }
 
 /*!
  * @brief エントリを無効にする
+ * @param generation テーブルの世代
  */
-void RoutingTable::Entry::markInvalid() { isValid_ = false; }
+void RoutingTable::Entry::markInvalid(const int generation) {
+    isValid_ = false;
+    generation_ = generation;
+}
@@ -8,22 +8,28 @@
 #ifndef ROUTINGTABLE_HPP
 #define ROUTINGTABLE_HPP
 
+#include <cstdint>
 #include <map>
 #include <vector>
 using namespace std;
 
 /* ルーティングテーブルクラス */
 class RoutingTable {
-   private:
+   public:
     /* 各デバイスのエントリクラス */
     class Entry;
+
+   private:
     /* ルーティングテーブル */
     map<int, Entry> table_;
+    /* 世代 (エントリが変化するたびに進む) */
+    int generation_;
 
    public:
     RoutingTable();
 
     int getNumEntry() const;
+    int getGeneration() const;
     int getIdNextHop(const int id_dest) const;
     int getNumHop(const int id_dest) const;
 
@@ -31,11 +37,63 @@ class RoutingTable {
     vector<int> getDestinations() const;
 
     bool hasEntry(const int id_dest) const;
+    bool isEntryValid(const int id_dest) const;
 
     bool setEntry(const int id_dest, const int id_nextHop_,
                   const int distance = 0);
     void markEntryInvalid(const int id_dest);
+    void refreshEntry(const int id_dest);
     void clearEntryAll();
+
+    RoutingTable makeDelta(const int since_generation) const;
+
+    template <class F>
+    void forEachEntry(F &&func) const;
+};
+
+/* ID を添字とする密なルーティングテーブルクラス */
+/* デバイスIDが 0 から連番であることを前提に、エントリを配列で持つ */
+class FlatRoutingTable {
+   public:
+    /* 各デバイスのエントリクラス */
+    using Entry = RoutingTable::Entry;
+
+   private:
+    /* 宛先IDを添字とするエントリ */
+    vector<Entry> entries_;
+    /* エントリの有無を表すビット列 */
+    vector<uint64_t> has_entry_;
+    /* 総エントリ数 */
+    int num_entry_;
+    /* 世代 (エントリが変化するたびに進む) */
+    int generation_;
+
+   public:
+    FlatRoutingTable();
+
+    int getNumEntry() const;
+    int getGeneration() const;
+    int getIdNextHop(const int id_dest) const;
+    int getNumHop(const int id_dest) const;
+
+    vector<int> getDestinations() const;
+
+    bool hasEntry(const int id_dest) const;
+    bool isEntryValid(const int id_dest) const;
+
+    bool setEntry(const int id_dest, const int id_nextHop_,
+                  const int distance = 0);
+    void markEntryInvalid(const int id_dest);
+    void refreshEntry(const int id_dest);
+    void clearEntryAll();
+
+    FlatRoutingTable makeDelta(const int since_generation) const;
+
+    template <class F>
+    void forEachEntry(F &&func) const;
+
+   private:
+    void reserveEntry(const int id_dest);
 };
 
 /* 各デバイスのエントリクラス */
@@ -47,21 +105,26 @@ class RoutingTable::Entry {
     int num_hop_;
     /* エントリが有効かどうか */
     bool isValid_;
+    /* 最後に変化したときのテーブルの世代 */
+    int generation_;
 
    public:
     Entry() = default;
-    Entry(const int id_nextHop_, const int distance = 0);
+    Entry(const int id_nextHop_, const int distance = 0,
+          const int generation = 0);
 
     int getIdNextHop() const;
     int getNumHop() const;
     bool isValid() const;
+    int getGeneration() const;
 
-    void setEntry(const int id_nextHop_, const int distance = 0);
-    void markInvalid();
+    void setEntry(const int id_nextHop_, const int distance = 0,
+                  const int generation = 0);
+    void markInvalid(const int generation = 0);
 };
 
 /* ルーティングテーブルクラス */
-using Table = RoutingTable;
+using Table = FlatRoutingTable;
 
 #include "routingTable.cpp"
 
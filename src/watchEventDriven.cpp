@@ -0,0 +1,109 @@
+/*!
+ * @file watchEventDriven.cpp
+ * @author tom96da
+ * @brief 離散事象シミュレーションによる収束時間の確認
+ * @details 同じトポロジーで、ラウンド単位の経路表作成と事象駆動の経路表作成を
+ *          比較する。リンク遅延はデバイス間距離に比例させる。
+ * @date 2026-10-17
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include "DeviceManager.hpp"
+#include "EventScheduler.hpp"
+
+using namespace std;
+
+int main() {
+    /* フィールドサイズ */
+    const double field_size = 60;
+    /* ノード数 */
+    const int num_node = 100;
+
+    std::cout << "field size: " << field_size << "x" << field_size << ", "
+              << "number of node: " << num_node << std::endl;
+
+    /*　マネージャー */
+    auto mgr = new MGR{field_size};
+    mgr->setSimMode(SIMMODE::CONVENTIONAL);
+
+    // 孤立しないネットワークを構築する
+    while (true) {
+        mgr->deleteDeviceAll();
+        mgr->addDevices(num_node);
+        mgr->buildNetwork();
+        if (mgr->isConnectedGraph()) {
+            break;
+        }
+    }
+
+    auto &context = mgr->getContext();
+
+    {  // ラウンド単位
+        auto start = chrono::steady_clock::now();
+        int num_packet_start = context.getTotalPacket();
+        int num_update = 0;
+
+        mgr->sendHello();
+        mgr->makeMPR();
+        while (true) {
+            mgr->sendTable();
+            if (mgr->makeTable() == 0) {
+                break;
+            }
+            ++num_update;
+        }
+
+        auto time = chrono::duration_cast<chrono::microseconds>(
+                        chrono::steady_clock::now() - start)
+                        .count();
+        std::cout << "round-based : " << num_update << " rounds, "
+                  << context.getTotalPacket() - num_packet_start
+                  << " packets, " << time << " us, "
+                  << mgr->verifyTable() << " wrong entries" << std::endl;
+    }
+
+    mgr->clearDevice();
+
+    {  // 事象駆動
+        /* スケジューラ リンク遅延は 1ms + 距離に比例 */
+        auto scheduler = EventScheduler();
+        scheduler.setLinkLatency([&](const int id_1, const int id_2) {
+            return 1.0 + mgr->getDistance(id_1, id_2) / MAX_COM_DISTANCE;
+        });
+
+        auto start = chrono::steady_clock::now();
+        int num_packet_start = context.getTotalPacket();
+
+        double time_converged = mgr->makeTableEventDriven(scheduler);
+
+        auto time = chrono::duration_cast<chrono::microseconds>(
+                        chrono::steady_clock::now() - start)
+                        .count();
+        std::cout << "event-driven: converged at " << time_converged
+                  << " ms (simulated), "
+                  << context.getTotalPacket() - num_packet_start
+                  << " packets, " << scheduler.getNumProcessed()
+                  << " events, " << time << " us, " << mgr->verifyTable()
+                  << " wrong entries" << std::endl;
+
+        scheduler.reset();
+        auto [num_reach, time_reach] =
+            mgr->floodingEventDriven(mgr->getCentralDevice(), scheduler);
+        std::cout << "flooding    : " << num_reach << " devices reached in "
+                  << time_reach << " ms (simulated)" << std::endl;
+    }
+
+    {  // 全点対ホップ数
+        auto hop_matrix = mgr->makeHopMatrix();
+        std::cout << "hop matrix  : average " << hop_matrix.getAverageHop()
+                  << " hops, diameter " << hop_matrix.getDiameter()
+                  << " hops, central device " << hop_matrix.getCentralNode()
+                  << std::endl;
+    }
+
+    delete mgr;
+
+    return 0;
+}
@@ -58,8 +58,7 @@ int main() {
         mgr->deleteDeviceAll();
         mgr->addDevices(num_node);
         mgr->buildNetwork();
-        const auto [_, num_member] = mgr->flooding(45);
-        if (num_member == num_node) {
+        if (mgr->isConnectedGraph()) {
             // 孤立するノードがなければ抜ける
             break;
         }
@@ -80,8 +79,7 @@ int main() {
     {  // 提案手法 遠距離選択接続
         mgr->setSimMode(SIMMODE::PROPOSAL_LONG_CONNECTION);
         mgr->buildNetwork();
-        const auto [_, num_member] = mgr->flooding(45);
-        if (num_member != num_node) {
+        if (!mgr->isConnectedGraph()) {
             // 孤立するノードがあれば
             return 0;
         }